@@ -10,10 +10,12 @@
 #include "CoreHeaders.h"
 #include "ComponentManager.h"
 #include "CoreComponents.h"
+#include "CoreSystems.h"
 #include "GameCore.h"
 #include "Objects/GameObject.h"
 #include "Scenes/Scene.h"
 #include "Resources/ResourceManager.h"
+#include "Utility/Profiler.h"
 
 namespace fw {
 
@@ -23,6 +25,49 @@ ComponentManager::ComponentManager()
     RegisterComponentDefinition( m_FlecsWorld.component<NameData>(), new NameComponentDefinition() );
     RegisterComponentDefinition( m_FlecsWorld.component<TransformData>(), new TransformComponentDefinition() );
     RegisterComponentDefinition( m_FlecsWorld.component<MeshData>(), new MeshComponentDefinition() );
+    RegisterComponentDefinition( m_FlecsWorld.component<SpriteData>(), new SpriteComponentDefinition() );
+
+    m_FlecsWorld.set_ctx( this );
+
+    m_RootTransformQuery = m_FlecsWorld.query_builder<const TransformData, TransformMatrixData>()
+        .without<TransformMatrixData>().parent()
+        .cached()
+        .build();
+
+    m_ChildTransformQuery = m_FlecsWorld.query_builder<const TransformData, TransformMatrixData, const TransformMatrixData>()
+        .term_at( 2 ).parent().cascade()
+        .cached()
+        .build();
+    m_MeshQuery = m_FlecsWorld.query_builder<const TransformMatrixData, const MeshData>().cached().build();
+    m_SpriteQuery = m_FlecsWorld.query_builder<const TransformMatrixData, const SpriteData>().cached().build();
+
+    // Same as flecs' default pipeline, split around PreStore.
+    m_UpdatePipeline = m_FlecsWorld.pipeline()
+        .with( flecs::System )
+        .with( flecs::Phase ).cascade( flecs::DependsOn )
+        .without( flecs::Disabled ).up( flecs::DependsOn )
+        .without( flecs::Disabled ).up( flecs::ChildOf )
+        .without( flecs::PreStore )
+        .without( flecs::OnStore )
+        .build();
+
+    m_PreparePipeline = m_FlecsWorld.pipeline()
+        .with( flecs::System )
+        .with( flecs::Phase ).cascade( flecs::DependsOn )
+        .without( flecs::Disabled ).up( flecs::DependsOn )
+        .without( flecs::Disabled ).up( flecs::ChildOf )
+        .with( flecs::PreStore )
+        .build();
+
+    m_StorePipeline = m_FlecsWorld.pipeline()
+        .with( flecs::System )
+        .with( flecs::Phase ).cascade( flecs::DependsOn )
+        .without( flecs::Disabled ).up( flecs::DependsOn )
+        .without( flecs::Disabled ).up( flecs::ChildOf )
+        .with( flecs::OnStore )
+        .build();
+
+    RegisterCoreSystems();
 }
 
 ComponentManager::~ComponentManager()
@@ -33,6 +78,133 @@ ComponentManager::~ComponentManager()
     }
 }
 
+void ComponentManager::RegisterCoreSystems()
+{
+    // Same work as System_UpdateAllTransforms.
+    // Root transforms don't depend on each other, so they're split across all threads.
+    // Children then run on the main thread in depth order, once all their roots are done.
+    m_FlecsWorld.system<const TransformData, TransformMatrixData>( "System_UpdateRootTransforms" )
+        .without<TransformMatrixData>().parent()
+        .kind( flecs::PreStore )
+        .multi_threaded()
+        .run(
+            [this](flecs::iter& it)
+            {
+                uint32 pass = m_TransformPass;
+                ForEachTable<const TransformData, TransformMatrixData>( it,
+                    [pass](size_t count, const TransformData* pTransforms, TransformMatrixData* pMatrices)
+                    {
+                        UpdateRootTransformsForTable( count, pTransforms, pMatrices, pass );
+                    }
+                );
+            }
+        );
+
+    m_FlecsWorld.system<const TransformData, TransformMatrixData, const TransformMatrixData>( "System_UpdateChildTransforms" )
+        .term_at( 2 ).parent().cascade()
+        .kind( flecs::PreStore )
+        .run(
+            [this](flecs::iter& it)
+            {
+                UpdateChildTransforms( it, m_TransformPass );
+            }
+        );
+
+    // Runs after the transform systems above, since systems in a phase run in the order they're created.
+    // Pushes to a single vector, so this stays on the main thread.
+    m_FlecsWorld.system<const TransformMatrixData, const MeshData>( "System_BuildDrawList" )
+        .kind( flecs::PreStore )
+        .run(
+            [this](flecs::iter& it)
+            {
+                flecs::world world = it.real_world();
+                while( it.next() )
+                {
+                    flecs::field<const TransformMatrixData> matrices = it.field<const TransformMatrixData>( 0 );
+                    flecs::field<const MeshData> meshes = it.field<const MeshData>( 1 );
+
+                    BuildDrawListForTable( it.count(), &matrices[0], &meshes[0], &it.entities()[0], world, m_DrawList );
+                }
+            }
+        );
+
+    // Same work as System_BuildSpriteBatch.
+    m_FlecsWorld.system<const TransformMatrixData, const SpriteData>( "System_BuildSpriteBatch" )
+        .kind( flecs::PreStore )
+        .run(
+            [this](flecs::iter& it)
+            {
+                SpriteBatch* pBatch = &m_SpriteBatch;
+                ForEachTable<const TransformMatrixData, const SpriteData>( it,
+                    [pBatch](size_t count, const TransformMatrixData* pMatrices, const SpriteData* pSprites)
+                    {
+                        AddSpritesForTable( count, pMatrices, pSprites, pBatch );
+                    }
+                );
+            }
+        );
+}
+
+void ComponentManager::SetNumThreads(uint32 numThreads)
+{
+    m_FlecsWorld.set_threads( numThreads > 1 ? numThreads : 0 );
+}
+
+uint32 ComponentManager::BeginTransformPass()
+{
+    m_TransformPass++;
+    if( m_TransformPass == 0 )
+        m_TransformPass = 1;
+
+    return m_TransformPass;
+}
+
+void ComponentManager::RunUpdatePhases(float deltaTime)
+{
+    FW_PROFILE_SCOPE( "ComponentManager::RunUpdatePhases" );
+
+    m_FlecsWorld.run_pipeline( m_UpdatePipeline, deltaTime );
+}
+
+void ComponentManager::RunPreparePhases()
+{
+    FW_PROFILE_SCOPE( "ComponentManager::RunPreparePhases" );
+
+    BeginTransformPass();
+    m_DrawList.clear();
+    m_SpriteBatch.Begin();
+
+    m_FlecsWorld.run_pipeline( m_PreparePipeline, 0 );
+
+    m_SpriteBatch.End();
+
+    // Keeps state changes down and lets each submission chunk work through a run of similar draws.
+    std::sort( m_DrawList.begin(), m_DrawList.end(),
+        [](const DrawListItem& a, const DrawListItem& b)
+        {
+            if( a.pMaterial != b.pMaterial )
+                return a.pMaterial < b.pMaterial;
+            return a.pMesh < b.pMesh;
+        }
+    );
+}
+
+uint32 ComponentManager::RunStorePhases(const RenderContext& context)
+{
+    FW_PROFILE_SCOPE( "ComponentManager::RunStorePhases" );
+
+    m_RenderContext = context;
+
+    uint32 numCulled = SubmitDrawList( m_DrawList, context );
+    SubmitSpriteBatch( &m_SpriteBatch, context );
+
+    m_FlecsWorld.run_pipeline( m_StorePipeline, 0 );
+
+    m_RenderContext = RenderContext();
+
+    return numCulled;
+}
+
 void ComponentManager::RegisterComponentDefinition(flecs::id_t componentId, BaseComponentDefinition* pComponentDefinition)
 {
     m_ComponentDefinitions[componentId] = pComponentDefinition;
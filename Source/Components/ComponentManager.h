@@ -9,18 +9,96 @@
 
 #pragma once
 
+#include <utility>
+
+#include "Components/CoreComponents.h"
+#include "Renderer/SpriteBatch.h"
+
 namespace fw {
 
 class BaseComponentDefinition;
+class Frustum;
 class GameObject;
+class Material;
+class Mesh;
+class RenderSnapshot;
 class Scene;
+class Uniforms;
 
+// Owns the flecs world and runs its systems in three pipelines:
+//    Update phases (everything before PreStore) - Run once per frame from Scene::Update.
+//    Prepare phase (PreStore)                   - Run once per frame from Scene::Prepare, before the first view is drawn.
+//    Store phase (OnStore)                      - Run once per view from Scene::DrawIntoView.
+// The prepare phase updates transforms and builds the draw list and sprite batch, so each view only culls and submits them.
+// Systems in the store phase can read the view being drawn from GetRenderContext().
+// The world's ctx points back to its ComponentManager, so systems can find it with it.world().get_ctx().
+// Systems marked multi_threaded() are split across the worker threads set by SetNumThreads.
+//
+// Queries used every frame should be built once with .cached() and kept around, like the core queries below.
+// ForEachTable walks a query or system iterator a table at a time, handing over each component column as an array.
 class ComponentManager
 {
+public:
+    struct RenderContext
+    {
+        int viewID = 0;
+        Uniforms* pUniforms = nullptr;
+        RenderSnapshot* pSnapshot = nullptr;
+        const Frustum* pFrustum = nullptr; // nullptr if the view isn't culled.
+        enki::TaskScheduler* pTaskScheduler = nullptr; // Set to submit the draw list in parallel, ignored when recording a snapshot.
+
+        // LOD selection, meshes always draw LOD 0 if there's no view projection.
+        const mat4* pViewProj = nullptr;
+        uint32 frameNumber = 0;
+        float time = 0; // In seconds, for cross-fades.
+        float lodFadeDuration = 0; // 0 switches LODs without cross-fading.
+    };
+
+    // A mesh to draw this frame, with its bounding sphere in world space.
+    struct DrawListItem
+    {
+        mat4 worldMatrix;
+        vec3 boundsCenter;
+        float boundsRadius; // Negative if the mesh has no bounds, these are never culled.
+        Mesh* pMesh;
+        Material* pMaterial;
+        // For LOD state. Held by entity rather than pointing into the MeshData column, since tables can
+        //   move or grow between Prepare and a later view, e.g. when deferred commands are merged.
+        flecs::entity entity;
+    };
+
 public:
     ComponentManager();
     ~ComponentManager();
 
+    void SetNumThreads(uint32 numThreads);
+
+    void RunUpdatePhases(float deltaTime);
+    // The draw list is sorted by material and mesh once it's built.
+    void RunPreparePhases();
+    // Submits the draw list items inside the context's frustum, or all of them if it has none.
+    // Returns the number of items culled.
+    uint32 RunStorePhases(const RenderContext& context);
+
+    // Each transform update gets a new pass number, used to tell which parents changed during it.
+    uint32 BeginTransformPass();
+    uint32 GetTransformPass() { return m_TransformPass; }
+
+    // Calls func( count, Component1*, Component2*, ... ) once per matched table.
+    // Every term must be owned by the entities, i.e. no singletons or up traversal.
+    template<typename... Components, typename Func> static void ForEachTable(flecs::iter& it, Func&& func)
+    {
+        while( it.next() )
+        {
+            CallWithColumns<Components...>( it, func, std::index_sequence_for<Components...>() );
+        }
+    }
+
+    template<typename... Components, typename Func> static void ForEachTable(flecs::query<Components...>& query, Func&& func)
+    {
+        query.run( [&func](flecs::iter& it) { ForEachTable<Components...>( it, func ); } );
+    }
+
     void RegisterComponentDefinition(flecs::id_t componentId, BaseComponentDefinition* pComponentDefinition);
     template<typename DataType, typename ComponentDefType> void RegisterComponentDefinition()
     {
@@ -37,9 +115,41 @@ public:
 
     // Getters.
     flecs::world& GetFlecsWorld() { return m_FlecsWorld; }
+    const RenderContext& GetRenderContext() { return m_RenderContext; }
+    const std::vector<DrawListItem>& GetDrawList() { return m_DrawList; }
+    SpriteBatch* GetSpriteBatch() { return &m_SpriteBatch; }
+
+    // Cached queries for the core systems.
+    // Root transforms have no ancestor with a TransformMatrixData, child transforms are sorted by depth.
+    flecs::query<const TransformData, TransformMatrixData>& GetRootTransformQuery() { return m_RootTransformQuery; }
+    flecs::query<const TransformData, TransformMatrixData, const TransformMatrixData>& GetChildTransformQuery() { return m_ChildTransformQuery; }
+    flecs::query<const TransformMatrixData, const MeshData>& GetMeshQuery() { return m_MeshQuery; }
+    flecs::query<const TransformMatrixData, const SpriteData>& GetSpriteQuery() { return m_SpriteQuery; }
+
+protected:
+    void RegisterCoreSystems();
+
+    template<typename... Components, typename Func, size_t... Indices> static void CallWithColumns(flecs::iter& it, Func& func, std::index_sequence<Indices...>)
+    {
+        func( (size_t)it.count(), &it.field<Components>( Indices )[0]... );
+    }
 
 protected:
     flecs::world m_FlecsWorld;
+    flecs::entity m_UpdatePipeline;
+    flecs::entity m_PreparePipeline;
+    flecs::entity m_StorePipeline;
+    RenderContext m_RenderContext;
+    uint32 m_TransformPass = 0;
+
+    // Rebuilt by the prepare phase, the capacity is kept between frames.
+    std::vector<DrawListItem> m_DrawList;
+    SpriteBatch m_SpriteBatch;
+
+    flecs::query<const TransformData, TransformMatrixData> m_RootTransformQuery;
+    flecs::query<const TransformData, TransformMatrixData, const TransformMatrixData> m_ChildTransformQuery;
+    flecs::query<const TransformMatrixData, const MeshData> m_MeshQuery;
+    flecs::query<const TransformMatrixData, const SpriteData> m_SpriteQuery;
     std::map<flecs::id_t, BaseComponentDefinition*> m_ComponentDefinitions;
 };
 
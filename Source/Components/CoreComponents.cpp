@@ -11,6 +11,7 @@
 #include "Resources/Mesh.h"
 #include "Resources/Material.h"
 #include "Resources/ResourceManager.h"
+#include "Resources/SpriteSheet.h"
 
 namespace fw {
 
@@ -44,12 +45,27 @@ void NameComponentDefinition::Editor_AddToInspector(flecs::entity entity)
 // TransformComponentDefinition
 //==============================
 
+mat4 TransformData::GetLocalMatrix() const
+{
+    mat4 matrix;
+    if( useQuaternion )
+        matrix.CreateSRT( scale, orientation, position );
+    else
+        matrix.CreateSRT( scale, rotation, position );
+    return matrix;
+}
+
 void TransformComponentDefinition::SaveToJSON(GameObject* pObject, nlohmann::json& jComponent, const void* pData)
 {
     TransformData* pTransformData = (TransformData*)pData;
     jComponent["Position"] = { pTransformData->position.x, pTransformData->position.y, pTransformData->position.z };
     jComponent["Rotation"] = { pTransformData->rotation.x, pTransformData->rotation.y, pTransformData->rotation.z };
     jComponent["Scale"] = { pTransformData->scale.x, pTransformData->scale.y, pTransformData->scale.z };
+    if( pTransformData->useQuaternion )
+    {
+        const quat& orientation = pTransformData->orientation;
+        jComponent["Orientation"] = { orientation.x, orientation.y, orientation.z, orientation.w };
+    }
 }
 
 void TransformComponentDefinition::LoadFromJSON(GameObject* pObject, flecs::entity entity, nlohmann::json& jComponent, ResourceManager* pResourceManager)
@@ -58,6 +74,12 @@ void TransformComponentDefinition::LoadFromJSON(GameObject* pObject, flecs::enti
     transformData.position = vec3( jComponent["Position"][0], jComponent["Position"][1], jComponent["Position"][2] );
     transformData.rotation = vec3( jComponent["Rotation"][0], jComponent["Rotation"][1], jComponent["Rotation"][2] );
     transformData.scale = vec3( jComponent["Scale"][0], jComponent["Scale"][1], jComponent["Scale"][2] );
+    if( jComponent.contains( "Orientation" ) )
+    {
+        nlohmann::json& jOrientation = jComponent["Orientation"];
+        transformData.orientation = quat( jOrientation[0], jOrientation[1], jOrientation[2], jOrientation[3] );
+        transformData.useQuaternion = true;
+    }
     entity.set<TransformData>( transformData );
 }
 
@@ -67,8 +89,25 @@ void TransformComponentDefinition::Editor_AddToInspector(flecs::entity entity)
     if( ImGui::CollapsingHeader( "Transform", ImGuiTreeNodeFlags_DefaultOpen ) )
     {
         ImGui::DragFloat3( "Position", &transformData.position.x, 0.1f );
-        ImGui::DragFloat3( "Rotation", &transformData.rotation.x, 0.1f );
+        if( transformData.useQuaternion )
+        {
+            // Edit as euler angles, the rotation field is kept in sync for display.
+            if( ImGui::DragFloat3( "Rotation", &transformData.rotation.x, 0.1f ) )
+                transformData.orientation = quat::CreateFromEuler( transformData.rotation );
+        }
+        else
+        {
+            ImGui::DragFloat3( "Rotation", &transformData.rotation.x, 0.1f );
+        }
         ImGui::DragFloat3( "Scale", &transformData.scale.x, 0.1f );
+
+        if( ImGui::Checkbox( "Quaternion", &transformData.useQuaternion ) )
+        {
+            if( transformData.useQuaternion )
+                transformData.orientation = quat::CreateFromEuler( transformData.rotation );
+            else
+                transformData.rotation = transformData.orientation.GetEulerAngles();
+        }
     }
     entity.modified<TransformData>();
 }
@@ -121,4 +160,89 @@ void MeshComponentDefinition::Editor_AddToInspector(flecs::entity entity)
     }
 }
 
+//==============================
+// SpriteComponentDefinition
+//==============================
+
+void SpriteData::SetSprite(SpriteSheet* pSheet, const char* name)
+{
+    SetSprite( pSheet, pSheet ? pSheet->GetSpriteID( name ) : SpriteSheet::c_InvalidSpriteID );
+}
+
+void SpriteData::SetSprite(SpriteSheet* pSheet, uint16 id)
+{
+    pSpriteSheet = pSheet;
+    spriteID = id;
+
+    if( pSpriteSheet && spriteID != SpriteSheet::c_InvalidSpriteID )
+    {
+        const SpriteSheet::SpriteInfo& info = pSpriteSheet->GetSprite( spriteID );
+        uvScale = info.uvScale;
+        uvOffset = info.uvOffset;
+    }
+    else
+    {
+        uvScale.Set( 1, 1 );
+        uvOffset.Set( 0, 0 );
+    }
+}
+
+void SpriteComponentDefinition::SaveToJSON(GameObject* pObject, nlohmann::json& jComponent, const void* pData)
+{
+    SpriteData* pSpriteData = (SpriteData*)pData;
+    jComponent["Material"] = pSpriteData->pMaterial->GetName();
+    if( pSpriteData->pSpriteSheet && pSpriteData->spriteID != SpriteSheet::c_InvalidSpriteID )
+    {
+        jComponent["SpriteSheet"] = pSpriteData->pSpriteSheet->GetName();
+        jComponent["Sprite"] = pSpriteData->pSpriteSheet->GetSpriteName( pSpriteData->spriteID );
+    }
+    jComponent["Color"] = { pSpriteData->color.r, pSpriteData->color.g, pSpriteData->color.b, pSpriteData->color.a };
+}
+
+void SpriteComponentDefinition::LoadFromJSON(GameObject* pObject, flecs::entity entity, nlohmann::json& jComponent, ResourceManager* pResourceManager)
+{
+    SpriteData spriteData;
+    spriteData.pMaterial = pResourceManager->GetMaterial( jComponent["Material"] );
+    if( jComponent.contains( "SpriteSheet" ) )
+    {
+        std::string spriteName = jComponent["Sprite"];
+        spriteData.SetSprite( pResourceManager->GetSpriteSheet( jComponent["SpriteSheet"] ), spriteName.c_str() );
+    }
+    if( jComponent.contains( "Color" ) )
+    {
+        nlohmann::json& jColor = jComponent["Color"];
+        spriteData.color = color4f( (float)jColor[0], (float)jColor[1], (float)jColor[2], (float)jColor[3] );
+    }
+    entity.set<SpriteData>( spriteData );
+}
+
+void SpriteComponentDefinition::Editor_AddToInspector(flecs::entity entity)
+{
+    SpriteData& spriteData = entity.ensure<SpriteData>();
+    if( ImGui::CollapsingHeader( "Sprite", ImGuiTreeNodeFlags_DefaultOpen ) )
+    {
+        SpriteSheet* pSheet = spriteData.pSpriteSheet;
+
+        ImGui::Text( "Material: %s", spriteData.pMaterial ? spriteData.pMaterial->GetName() : "None" );
+        ImGui::Text( "SpriteSheet: %s", pSheet ? pSheet->GetName() : "None" );
+        if( pSheet )
+        {
+            const char* currentName = spriteData.spriteID != SpriteSheet::c_InvalidSpriteID ? pSheet->GetSpriteName( spriteData.spriteID ) : "None";
+            if( ImGui::BeginCombo( "Sprite", currentName ) )
+            {
+                for( uint32 i=0; i<pSheet->GetNumSprites(); i++ )
+                {
+                    if( ImGui::Selectable( pSheet->GetSpriteName( (uint16)i ), i == spriteData.spriteID ) )
+                    {
+                        spriteData.SetSprite( pSheet, (uint16)i );
+                    }
+                }
+                ImGui::EndCombo();
+            }
+        }
+        ImGui::ColorEdit4( "Color", &spriteData.color.r );
+    }
+    entity.modified<SpriteData>();
+}
+
 } // namespace fw
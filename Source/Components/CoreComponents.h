@@ -11,6 +11,7 @@
 
 #include "Math/Vector.h"
 #include "Math/Matrix.h"
+#include "Math/Quaternion.h"
 
 namespace fw {
 
@@ -19,6 +20,7 @@ class Mesh;
 class Material;
 class ResourceManager;
 class Scene;
+class SpriteSheet;
 
 //==============================
 // BaseComponentDefinition
@@ -43,7 +45,7 @@ struct NameData
     char name[c_MaxNameLength];
 
     NameData() { name[0] = '\0'; }
-    NameData(const char* newName) { strncpy_s( name, c_MaxNameLength, newName, c_MaxNameLength ); }
+    NameData(const char* newName) { strncpy( name, newName, c_MaxNameLength-1 ); name[c_MaxNameLength-1] = '\0'; }
 };
 
 class NameComponentDefinition : public BaseComponentDefinition
@@ -59,11 +61,16 @@ public:
 // TransformComponent
 //====================
 
+// Rotation is stored as euler degrees unless useQuaternion is set, in which case orientation is used.
 struct TransformData
 {
     vec3 position = 0;
     vec3 rotation = 0;
     vec3 scale = 0;
+    quat orientation = quat::Identity();
+    bool useQuaternion = false;
+
+    mat4 GetLocalMatrix() const;
 };
 
 class TransformComponentDefinition : public BaseComponentDefinition
@@ -79,9 +86,15 @@ public:
 // TransformMatrixData
 //====================
 
+// World transform, built from TransformData and the nearest ancestor (flecs ChildOf) with a TransformMatrixData.
+// The rest is bookkeeping so unchanged transforms can be skipped, see UpdateRootTransformsForTable.
 struct TransformMatrixData
 {
     mat4 transform;
+
+    TransformData lastLocal;
+    flecs::entity_t lastParent = 0;
+    uint32 changedPass = 0; // Transform pass this last changed in, 0 if never built.
 };
 
 class TransformMatrixComponentDefinition : public BaseComponentDefinition
@@ -101,6 +114,12 @@ struct MeshData
 {
     Mesh* pMesh = nullptr;
     Material* pMaterial = nullptr;
+
+    // LOD state, moved along by the first view to draw the mesh each frame, see SubmitDrawList.
+    uint8 lod = 0;
+    uint8 fadeFromLOD = 0;
+    float fadeStartTime = -1; // Negative when not cross-fading.
+    uint32 lodFrame = 0xFFFFFFFF;
 };
 
 class MeshComponentDefinition : public BaseComponentDefinition
@@ -112,4 +131,33 @@ public:
     virtual void Editor_AddToInspector(flecs::entity entity) override;
 };
 
+//====================
+// SpriteComponent
+//====================
+
+// Drawn through the ComponentManager's SpriteBatch instead of as a mesh, along with the entity's TransformMatrixData.
+struct SpriteData
+{
+    Material* pMaterial = nullptr;
+    SpriteSheet* pSpriteSheet = nullptr; // nullptr uses the whole texture.
+    uint16 spriteID = 0xFFFF; // SpriteSheet::SpriteID.
+    vec2 uvScale = vec2(1,1);
+    vec2 uvOffset = vec2(0,0);
+    color4f color = color4f::White();
+
+    // The sprite's UVs are copied here, so drawing doesn't touch the sheet.
+    // Resolve names once and set IDs from then on, e.g. animation frames from SpriteSheet::GetClipFrame.
+    void SetSprite(SpriteSheet* pSheet, const char* name);
+    void SetSprite(SpriteSheet* pSheet, uint16 id);
+};
+
+class SpriteComponentDefinition : public BaseComponentDefinition
+{
+public:
+    virtual const char* GetName() override { return "SpriteData"; }
+    virtual void SaveToJSON(GameObject* pObject, nlohmann::json& jComponent, const void* pData) override;
+    virtual void LoadFromJSON(GameObject* pObject, flecs::entity entity, nlohmann::json& jComponent, ResourceManager* pResourceManager) override;
+    virtual void Editor_AddToInspector(flecs::entity entity) override;
+};
+
 } // namespace fw
@@ -11,35 +11,371 @@
 #include "CoreSystems.h"
 #include "Components/CoreComponents.h"
 #include "Components/ComponentManager.h"
+#include "Math/Frustum.h"
+#include "Renderer/RenderSnapshot.h"
+#include "Renderer/SpriteBatch.h"
 #include "Resources/Mesh.h"
+#include "Utility/AllocationTracker.h"
+#include "Utility/Profiler.h"
 
 namespace fw {
 
+static bool HasLocalTransformChanged(const TransformData& local, const TransformMatrixData& matrix)
+{
+    // Compare the floats exactly, the bool is followed by padding.
+    return memcmp( &local, &matrix.lastLocal, offsetof(TransformData, useQuaternion) ) != 0
+        || local.useQuaternion != matrix.lastLocal.useQuaternion;
+}
+
+// A transform is rebuilt if its local SRT changed, its parent changed, or its parent's transform
+//   was rebuilt during this pass. Anything else keeps last pass's matrix.
+void UpdateRootTransformsForTable(size_t count, const TransformData* pTransforms, TransformMatrixData* pMatrices, uint32 pass)
+{
+    for( size_t i=0; i<count; i++ )
+    {
+        TransformMatrixData& matrix = pMatrices[i];
+        if( matrix.changedPass != 0 && matrix.lastParent == 0 && HasLocalTransformChanged( pTransforms[i], matrix ) == false )
+            continue;
+
+        matrix.transform = pTransforms[i].GetLocalMatrix();
+        matrix.lastLocal = pTransforms[i];
+        matrix.lastParent = 0;
+        matrix.changedPass = pass;
+    }
+}
+
+void UpdateChildTransformsForTable(size_t count, const TransformData* pTransforms, TransformMatrixData* pMatrices, const TransformMatrixData* pParentMatrix, flecs::entity_t parent, uint32 pass)
+{
+    bool parentChanged = pParentMatrix->changedPass == pass;
+
+    for( size_t i=0; i<count; i++ )
+    {
+        TransformMatrixData& matrix = pMatrices[i];
+        if( matrix.changedPass != 0 && parentChanged == false && matrix.lastParent == parent && HasLocalTransformChanged( pTransforms[i], matrix ) == false )
+            continue;
+
+        matrix.transform = pParentMatrix->transform * pTransforms[i].GetLocalMatrix();
+        matrix.lastLocal = pTransforms[i];
+        matrix.lastParent = parent;
+        matrix.changedPass = pass;
+    }
+}
+
+void UpdateChildTransforms(flecs::iter& it, uint32 pass)
+{
+    // Tables come out of the cascade query sorted by depth, so parents are always done first.
+    // Every entity in a table has the same parent, which is the source of field 2.
+    while( it.next() )
+    {
+        flecs::field<const TransformData> transforms = it.field<const TransformData>( 0 );
+        flecs::field<TransformMatrixData> matrices = it.field<TransformMatrixData>( 1 );
+        flecs::field<const TransformMatrixData> parentMatrix = it.field<const TransformMatrixData>( 2 );
+
+        UpdateChildTransformsForTable( it.count(), &transforms[0], &matrices[0], &parentMatrix[0], it.src( 2 ), pass );
+    }
+}
+
+void DrawMeshesForTable(size_t count, const TransformMatrixData* pMatrices, const MeshData* pMeshes, int viewID, Uniforms* pUniforms)
+{
+    for( size_t i=0; i<count; i++ )
+    {
+        if( pMeshes[i].pMesh )
+        {
+            pMeshes[i].pMesh->Draw( viewID, pUniforms, pMeshes[i].pMaterial, &pMatrices[i].transform );
+        }
+    }
+}
+
+void ExtractMeshesForTable(size_t count, const TransformMatrixData* pMatrices, const MeshData* pMeshes, int viewID, RenderSnapshot* pSnapshot)
+{
+    for( size_t i=0; i<count; i++ )
+    {
+        if( pMeshes[i].pMesh )
+        {
+            pSnapshot->AddDrawItem( viewID, pMeshes[i].pMesh, pMeshes[i].pMaterial, pMatrices[i].transform );
+        }
+    }
+}
+
+void BuildDrawListForTable(size_t count, const TransformMatrixData* pMatrices, const MeshData* pMeshes, const flecs::entity_t* pEntities, flecs::world& world, std::vector<ComponentManager::DrawListItem>& drawList)
+{
+    for( size_t i=0; i<count; i++ )
+    {
+        Mesh* pMesh = pMeshes[i].pMesh;
+        if( pMesh == nullptr )
+            continue;
+
+        const mat4& world = pMatrices[i].transform;
+
+        ComponentManager::DrawListItem& item = drawList.emplace_back();
+        item.worldMatrix = world;
+        item.pMesh = pMesh;
+        item.pMaterial = pMeshes[i].pMaterial;
+        item.entity = flecs::entity( world, pEntities[i] );
+
+        if( pMesh->HasBounds() )
+        {
+            // Scale the radius by the largest axis, so the sphere still holds everything with non-uniform scale.
+            float scaleX = vec3( world.m11, world.m12, world.m13 ).LengthSquared();
+            float scaleY = vec3( world.m21, world.m22, world.m23 ).LengthSquared();
+            float scaleZ = vec3( world.m31, world.m32, world.m33 ).LengthSquared();
+            item.boundsCenter = world * pMesh->GetBoundsCenter();
+            item.boundsRadius = pMesh->GetBoundsRadius() * sqrtf( std::max( scaleX, std::max( scaleY, scaleZ ) ) );
+        }
+        else
+        {
+            item.boundsCenter = vec3( world.m41, world.m42, world.m43 );
+            item.boundsRadius = -1;
+        }
+    }
+}
+
+static void UpdateMeshLOD(MeshData* pMeshData, const Mesh* pMesh, float screenSize, const ComponentManager::RenderContext& context)
+{
+    if( pMeshData->lodFrame == context.frameNumber )
+        return;
+    pMeshData->lodFrame = context.frameNumber;
+
+    // Finish any cross-fade before picking a new LOD.
+    if( pMeshData->fadeStartTime >= 0 )
+    {
+        if( context.time - pMeshData->fadeStartTime < context.lodFadeDuration )
+            return;
+        pMeshData->fadeStartTime = -1;
+    }
+
+    uint32 lod = pMesh->SelectLOD( screenSize, pMeshData->lod );
+    if( lod == pMeshData->lod )
+        return;
+
+    if( context.lodFadeDuration > 0 )
+    {
+        pMeshData->fadeFromLOD = pMeshData->lod;
+        pMeshData->fadeStartTime = context.time;
+    }
+    pMeshData->lod = (uint8)lod;
+}
+
+static void SubmitDrawListItem(const ComponentManager::DrawListItem& item, uint32 lod, vec4 lodFade, const ComponentManager::RenderContext& context, bgfx::Encoder* pEncoder)
+{
+    if( context.pSnapshot )
+        context.pSnapshot->AddDrawItem( context.viewID, item.pMesh, item.pMaterial, item.worldMatrix, lod, lodFade );
+    else
+        item.pMesh->Draw( pEncoder, context.viewID, context.pUniforms, item.pMaterial, &item.worldMatrix, lod, lodFade );
+}
+
+// pEncoder can be nullptr when recording into a snapshot.
+static uint32 SubmitDrawListRange(const ComponentManager::DrawListItem* pItems, size_t count, const ComponentManager::RenderContext& context, bgfx::Encoder* pEncoder)
+{
+    uint32 numCulled = 0;
+
+    // A sphere's projected height is radius * (projection's y scale) / depth, both come from the view projection's rows.
+    // The y scale is the length of the 2nd row's xyz, as long as the view matrix has no scale.
+    const mat4* pViewProj = context.pViewProj;
+    float projScaleY = pViewProj ? vec3( pViewProj->m12, pViewProj->m22, pViewProj->m32 ).Length() : 0;
+
+    for( size_t i=0; i<count; i++ )
+    {
+        const ComponentManager::DrawListItem& item = pItems[i];
+        if( context.pFrustum && item.boundsRadius >= 0 && context.pFrustum->IsSphereVisible( item.boundsCenter, item.boundsRadius ) == false )
+        {
+            numCulled++;
+            continue;
+        }
+
+        // Looked up again rather than cached, the entity's table may have changed since the draw list was built.
+        MeshData* pMeshData = nullptr;
+        if( pViewProj && item.boundsRadius >= 0 && item.pMesh->GetNumLODs() > 1 && item.entity.is_alive() )
+        {
+            pMeshData = item.entity.get_mut<MeshData>();
+        }
+
+        if( pMeshData == nullptr )
+        {
+            SubmitDrawListItem( item, 0, vec4(1,0,0,0), context, pEncoder );
+            continue;
+        }
+
+        const vec3& center = item.boundsCenter;
+        float depth = pViewProj->m14 * center.x + pViewProj->m24 * center.y + pViewProj->m34 * center.z + pViewProj->m44;
+        // Cameras inside the sphere see it as filling the view.
+        float screenSize = depth > item.boundsRadius ? item.boundsRadius * projScaleY / depth : 1.0f;
+        UpdateMeshLOD( pMeshData, item.pMesh, screenSize, context );
+
+        // Cross-fading draws both LODs, each with the pixels the other one skips.
+        if( pMeshData->fadeStartTime >= 0 )
+        {
+            float fade = std::min( (context.time - pMeshData->fadeStartTime) / context.lodFadeDuration, 1.0f );
+            SubmitDrawListItem( item, pMeshData->lod, vec4(fade,0,0,0), context, pEncoder );
+            SubmitDrawListItem( item, pMeshData->fadeFromLOD, vec4(1-fade,1,0,0), context, pEncoder );
+        }
+        else
+        {
+            SubmitDrawListItem( item, pMeshData->lod, vec4(1,0,0,0), context, pEncoder );
+        }
+    }
+
+    return numCulled;
+}
+
+uint32 SubmitDrawList(const std::vector<ComponentManager::DrawListItem>& drawList, const ComponentManager::RenderContext& context)
+{
+    if( drawList.empty() )
+        return 0;
+
+    // RenderSnapshot isn't thread safe, so recording always happens here.
+    if( context.pSnapshot )
+    {
+        return SubmitDrawListRange( drawList.data(), drawList.size(), context, nullptr );
+    }
+
+    if( context.pTaskScheduler && drawList.size() >= SubmitDrawListTask::c_MinItemsPerChunk * 2 )
+    {
+        FW_PROFILE_SCOPE( "SubmitDrawList Parallel" );
+
+        SubmitDrawListTask task( drawList, context );
+        context.pTaskScheduler->AddTaskSetToPipe( &task );
+        context.pTaskScheduler->WaitforTask( &task );
+        return task.GetNumCulled();
+    }
+
+    // On the main thread this returns bgfx's main encoder, same as using the global bgfx api.
+    bgfx::Encoder* pEncoder = bgfx::begin();
+    uint32 numCulled = SubmitDrawListRange( drawList.data(), drawList.size(), context, pEncoder );
+    bgfx::end( pEncoder );
+
+    return numCulled;
+}
+
+void AddSpritesForTable(size_t count, const TransformMatrixData* pMatrices, const SpriteData* pSprites, SpriteBatch* pBatch)
+{
+    for( size_t i=0; i<count; i++ )
+    {
+        const SpriteData& sprite = pSprites[i];
+        if( sprite.pMaterial )
+        {
+            pBatch->AddSprite( sprite.pMaterial, pMatrices[i].transform, sprite.uvScale, sprite.uvOffset, sprite.color );
+        }
+    }
+}
+
+void SubmitSpriteBatch(SpriteBatch* pBatch, const ComponentManager::RenderContext& context)
+{
+    if( pBatch->GetNumSprites() == 0 )
+        return;
+
+    if( context.pSnapshot )
+    {
+        context.pSnapshot->AddSpriteBatch( context.viewID, pBatch );
+        return;
+    }
+
+    bgfx::Encoder* pEncoder = bgfx::begin();
+    pBatch->Submit( pEncoder, context.viewID, context.pUniforms );
+    bgfx::end( pEncoder );
+}
+
+SubmitDrawListTask::SubmitDrawListTask(const std::vector<ComponentManager::DrawListItem>& drawList, const ComponentManager::RenderContext& context)
+    : m_DrawList( drawList )
+    , m_Context( context )
+{
+    assert( context.pTaskScheduler != nullptr );
+
+    size_t numChunks = drawList.size() / c_MinItemsPerChunk;
+    numChunks = std::min<size_t>( numChunks, c_MaxChunks );
+    numChunks = std::min<size_t>( numChunks, context.pTaskScheduler->GetNumTaskThreads() );
+    numChunks = std::max<size_t>( numChunks, 1 );
+
+    m_ItemsPerChunk = (drawList.size() + numChunks - 1) / numChunks;
+    m_SetSize = (uint32_t)numChunks;
+    m_MinRange = 1;
+}
+
+void SubmitDrawListTask::ExecuteRange(enki::TaskSetPartition range, uint32_t threadnum)
+{
+    FW_ALLOC_TAG( AllocationTag::Renderer );
+
+    for( uint32_t chunk=range.start; chunk<range.end; chunk++ )
+    {
+        size_t start = chunk * m_ItemsPerChunk;
+        if( start >= m_DrawList.size() )
+            continue;
+
+        size_t count = std::min( m_ItemsPerChunk, m_DrawList.size() - start );
+
+        bgfx::Encoder* pEncoder = bgfx::begin( true );
+        assert( pEncoder != nullptr ); // Ran out of encoders, see BGFX_CONFIG_MAX_ENCODERS.
+        if( pEncoder == nullptr )
+            continue;
+
+        m_NumCulled += SubmitDrawListRange( &m_DrawList[start], count, m_Context, pEncoder );
+        bgfx::end( pEncoder );
+    }
+}
+
 void System_UpdateAllTransforms(fw::ComponentManager* pComponentManager)
 {
-    flecs::world& world = pComponentManager->GetFlecsWorld();
+    FW_PROFILE_SCOPE( "System_UpdateAllTransforms" );
+    FW_ALLOC_TAG( AllocationTag::ECS );
 
-    world.each<>(
-        [](TransformData& transformData, TransformMatrixData& transformMatrixData)
+    uint32 pass = pComponentManager->BeginTransformPass();
+
+    ComponentManager::ForEachTable( pComponentManager->GetRootTransformQuery(),
+        [pass](size_t count, const TransformData* pTransforms, TransformMatrixData* pMatrices)
         {
-            transformMatrixData.transform.CreateSRT( transformData.scale, transformData.rotation, transformData.position );
+            UpdateRootTransformsForTable( count, pTransforms, pMatrices, pass );
+        }
+    );
+
+    pComponentManager->GetChildTransformQuery().run(
+        [pass](flecs::iter& it)
+        {
+            UpdateChildTransforms( it, pass );
         }
     );
 }
 
 void System_DrawAllMeshes(fw::ComponentManager* pComponentManager, int viewID, fw::Uniforms* pUniforms)
 {
-    flecs::world& world = pComponentManager->GetFlecsWorld();
+    FW_PROFILE_SCOPE( "System_DrawAllMeshes" );
+    FW_ALLOC_TAG( AllocationTag::ECS );
 
-    world.each<>(
-        [viewID, pUniforms](TransformMatrixData& transformMatrixData, MeshData& meshData)
+    ComponentManager::ForEachTable( pComponentManager->GetMeshQuery(),
+        [viewID, pUniforms](size_t count, const TransformMatrixData* pMatrices, const MeshData* pMeshes)
         {
-            if( meshData.pMesh )
-            {
-                meshData.pMesh->Draw( viewID, pUniforms, meshData.pMaterial, &transformMatrixData.transform );
-            }
+            DrawMeshesForTable( count, pMatrices, pMeshes, viewID, pUniforms );
         }
     );
 }
 
+void System_ExtractAllMeshes(fw::ComponentManager* pComponentManager, int viewID, fw::RenderSnapshot* pSnapshot)
+{
+    FW_PROFILE_SCOPE( "System_ExtractAllMeshes" );
+    FW_ALLOC_TAG( AllocationTag::ECS );
+
+    ComponentManager::ForEachTable( pComponentManager->GetMeshQuery(),
+        [viewID, pSnapshot](size_t count, const TransformMatrixData* pMatrices, const MeshData* pMeshes)
+        {
+            ExtractMeshesForTable( count, pMatrices, pMeshes, viewID, pSnapshot );
+        }
+    );
+}
+
+void System_BuildSpriteBatch(fw::ComponentManager* pComponentManager, fw::SpriteBatch* pBatch)
+{
+    FW_PROFILE_SCOPE( "System_BuildSpriteBatch" );
+    FW_ALLOC_TAG( AllocationTag::ECS );
+
+    pBatch->Begin();
+
+    ComponentManager::ForEachTable( pComponentManager->GetSpriteQuery(),
+        [pBatch](size_t count, const TransformMatrixData* pMatrices, const SpriteData* pSprites)
+        {
+            AddSpritesForTable( count, pMatrices, pSprites, pBatch );
+        }
+    );
+
+    pBatch->End();
+}
+
 } // namespace fw
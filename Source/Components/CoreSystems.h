@@ -9,9 +9,60 @@
 
 #pragma once
 
+#include <atomic>
+
+#include "Components/ComponentManager.h"
+
 namespace fw {
 
+class Frustum;
+struct MeshData;
+struct SpriteData;
+struct TransformData;
+struct TransformMatrixData;
+
+// Per-table work shared by the manual systems and the flecs systems, see ComponentManager::ForEachTable.
+void UpdateRootTransformsForTable(size_t count, const TransformData* pTransforms, TransformMatrixData* pMatrices, uint32 pass);
+void UpdateChildTransformsForTable(size_t count, const TransformData* pTransforms, TransformMatrixData* pMatrices, const TransformMatrixData* pParentMatrix, flecs::entity_t parent, uint32 pass);
+void UpdateChildTransforms(flecs::iter& it, uint32 pass);
+void DrawMeshesForTable(size_t count, const TransformMatrixData* pMatrices, const MeshData* pMeshes, int viewID, Uniforms* pUniforms);
+void ExtractMeshesForTable(size_t count, const TransformMatrixData* pMatrices, const MeshData* pMeshes, int viewID, RenderSnapshot* pSnapshot);
+void BuildDrawListForTable(size_t count, const TransformMatrixData* pMatrices, const MeshData* pMeshes, const flecs::entity_t* pEntities, flecs::world& world, std::vector<ComponentManager::DrawListItem>& drawList);
+// Draws or extracts the items inside the context's frustum, all of them if it has none. Returns the number culled.
+// Draws are split into chunks across the context's task scheduler if it has one, see SubmitDrawListTask.
+// Meshes with LODs pick one by screen size if the context has a view projection. Each entity's LOD only moves
+//   once per frame, on the first view to draw it, so views drawn later in the frame reuse that choice.
+uint32 SubmitDrawList(const std::vector<ComponentManager::DrawListItem>& drawList, const ComponentManager::RenderContext& context);
+void AddSpritesForTable(size_t count, const TransformMatrixData* pMatrices, const SpriteData* pSprites, SpriteBatch* pBatch);
+// Sprite batches are always submitted from the calling thread, or recorded into the context's snapshot.
+void SubmitSpriteBatch(SpriteBatch* pBatch, const ComponentManager::RenderContext& context);
+
+// Submits a draw list in chunks on task scheduler threads, each chunk through its own bgfx encoder.
+// bgfx has BGFX_CONFIG_MAX_ENCODERS encoders (8 by default) shared with the main thread and FramePipeline,
+//   so the number of chunks is capped below that.
+class SubmitDrawListTask : public enki::ITaskSet
+{
+public:
+    static const uint32 c_MaxChunks = 6;
+    static const uint32 c_MinItemsPerChunk = 256;
+
+    SubmitDrawListTask(const std::vector<ComponentManager::DrawListItem>& drawList, const ComponentManager::RenderContext& context);
+
+    virtual void ExecuteRange(enki::TaskSetPartition range, uint32_t threadnum) override;
+
+    uint32 GetNumCulled() { return m_NumCulled; }
+
+protected:
+    const std::vector<ComponentManager::DrawListItem>& m_DrawList;
+    const ComponentManager::RenderContext& m_Context;
+    size_t m_ItemsPerChunk = 0;
+    std::atomic<uint32> m_NumCulled = 0;
+};
+
+// Manual versions of the core systems, ComponentManager also registers them as flecs systems.
 void System_UpdateAllTransforms(fw::ComponentManager* pComponentManager);
 void System_DrawAllMeshes(fw::ComponentManager* pComponentManager, int viewID, fw::Uniforms* pUniforms);
+void System_ExtractAllMeshes(fw::ComponentManager* pComponentManager, int viewID, fw::RenderSnapshot* pSnapshot);
+void System_BuildSpriteBatch(fw::ComponentManager* pComponentManager, fw::SpriteBatch* pBatch);
 
 } // namespace fw
@@ -13,11 +13,32 @@
 // Any changes to any of these headers will likely cause a full rebuild of the
 //   Framework project, which isn't desirable.
 
+// Platform selection.
+#if defined(_WIN32)
+#define FW_PLATFORM_WINDOWS 1
+#else
+#define FW_PLATFORM_POSIX 1
+#endif
+
+// The headless backend has no window or input and renders with bgfx's Noop renderer.
+// It's the only backend available on non-Windows platforms.
+#if !FW_PLATFORM_WINDOWS && !defined(FW_HEADLESS)
+#define FW_HEADLESS 1
+#endif
+
 // Platform headers.
+#if FW_PLATFORM_WINDOWS
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX
 #include <Windows.h>
 #include <windowsx.h>
+#else
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#define MAX_PATH 260
+#endif
 
 // Core c++ headers.
 #include <assert.h>
@@ -27,6 +48,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <algorithm>
 #include <map>
 #include <unordered_map>
 #include <vector>
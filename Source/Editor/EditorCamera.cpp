@@ -91,7 +91,7 @@ void EditorCamera::UpdateTransforms()
 void EditorCamera::Enable(int viewID)
 {
     // Setup view and projection matrices and uniforms.
-    bgfx::setViewTransform( viewID, &m_ViewMatrix.m11, &m_ProjectionMatrix.m11 );
+    m_pEditorCore->GetFramework()->SetViewTransform( viewID, m_ViewMatrix, m_ProjectionMatrix );
 }
 
 } // namespace fw
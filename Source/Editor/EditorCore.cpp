@@ -22,6 +22,7 @@
 #include "Resources/Material.h"
 #include "Resources/Mesh.h"
 #include "Scenes/Scene.h"
+#include "Utility/Profiler.h"
 #include "Utility/Utility.h"
 
 namespace fw {
@@ -92,6 +93,12 @@ void EditorCore::StartFrame(float deltaTime)
 
     Editor_CreateMainFrame();
     Editor_DisplayMainMenu();
+
+    // Editor windows are built here rather than in Update, Update might not run every frame.
+    Editor_DisplayObjectList();
+    Editor_ShowInspector();
+    Editor_ShowResources();
+    Editor_ShowProfiler();
 }
 
 bool EditorCore::OnEvent(Event* pEvent)
@@ -104,10 +111,6 @@ bool EditorCore::OnEvent(Event* pEvent)
 
 void EditorCore::Update(float deltaTime)
 {
-    Editor_DisplayObjectList();
-    Editor_ShowInspector();
-    Editor_ShowResources();
-
     if( m_pImGuiManager->WantsKeyboard() == false )
     {
         HandleKeyboardShortcuts();
@@ -230,6 +233,7 @@ void EditorCore::Editor_DisplayMainMenu()
     {
         // Show bgfx debug stats.
         ImGui::MenuItem( "Show Debug Stats", "", &m_ShowDebugStats );
+        ImGui::MenuItem( "Show Profiler", "", &m_Editor_ShowProfiler );
         ImGui::EndMenu();
     }
 
@@ -267,7 +271,7 @@ void EditorCore::Editor_DisplayMainMenu()
 
 void EditorCore::LoadScene(const char* filename)
 {
-    m_pEditor_SelectedObject = nullptr;
+    m_Editor_SelectedObject = GameObjectHandle();
     delete m_pActiveScene;
     m_pActiveScene = CreateScene();
     m_pActiveScene->Init();
@@ -297,13 +301,27 @@ void EditorCore::Editor_DisplayObjectList()
     ImGui::End(); // "Object List"
 }
 
+void EditorCore::Editor_SetSelectedObject(GameObject* pObject)
+{
+    m_Editor_SelectedObject = pObject ? pObject->GetHandle() : GameObjectHandle();
+}
+
+GameObject* EditorCore::Editor_GetSelectedObject()
+{
+    if( m_pActiveScene == nullptr )
+        return nullptr;
+
+    return m_pActiveScene->GetGameObject( m_Editor_SelectedObject );
+}
+
 void EditorCore::Editor_ShowInspector()
 {
     if( ImGui::Begin( "Inspector" ) )
     {
-        if( m_pEditor_SelectedObject )
+        GameObject* pSelectedObject = Editor_GetSelectedObject();
+        if( pSelectedObject )
         {
-            m_pActiveScene->GetComponentManager()->Editor_DisplayComponentsForGameObject( m_pEditor_SelectedObject );
+            m_pActiveScene->GetComponentManager()->Editor_DisplayComponentsForGameObject( pSelectedObject );
         }
     }
     ImGui::End();
@@ -324,6 +342,18 @@ void EditorCore::Editor_ShowResources()
     ImGui::End();
 }
 
+void EditorCore::Editor_ShowProfiler()
+{
+    if( m_Editor_ShowProfiler == false )
+        return;
+
+    if( ImGui::Begin( "Profiler", &m_Editor_ShowProfiler ) )
+    {
+        Profiler::Editor_DisplayTimeline();
+    }
+    ImGui::End();
+}
+
 void EditorCore::Editor_DrawGameView(int viewID)
 {
     m_Editor_GameViewInFocus = false;
@@ -392,7 +422,8 @@ void EditorCore::Editor_DrawEditorView(int viewID)
 
         ImGui::Image( fw::imguiTexture(m_Editor_FBOTexture), ImVec2( (float)m_Editor_WindowSize.x, (float)m_Editor_WindowSize.y ), uvMin, uvMax );
 
-        if( m_pEditor_SelectedObject )
+        GameObject* pSelectedObject = Editor_GetSelectedObject();
+        if( pSelectedObject )
         {
             ImVec2 pos = ImGui::GetWindowPos();
 
@@ -406,19 +437,40 @@ void EditorCore::Editor_DrawEditorView(int viewID)
                 ImGuizmo::SetDrawlist();
                 ImGuizmo::SetRect( pos.x + contentMin.x, pos.y + contentMin.y, size.x, size.y );
 
-                if( m_pEditor_SelectedObject->GetEntity().get<TransformData>() )
+                if( pSelectedObject->GetEntity().get<TransformData>() )
                 {
-                    TransformData& transform = m_pEditor_SelectedObject->GetEntity().ensure<TransformData>();
-                    worldMat.CreateSRT( transform.scale, transform.rotation, transform.position );
+                    TransformData& transform = pSelectedObject->GetEntity().ensure<TransformData>();
 
-                    if( ImGuizmo::Manipulate( &view.m11, &proj.m11, m_Editor_GizmoMode, ImGuizmo::MODE::LOCAL, &worldMat.m11, &deltaMat.m11 ) )
+                    // Children are stored relative to their nearest ancestor with a transform.
+                    mat4 parentMat;
+                    parentMat.SetIdentity();
+                    for( flecs::entity parent = pSelectedObject->GetParentEntity(); parent; parent = parent.parent() )
                     {
-                        transform.position = worldMat.GetTranslation();
-                        transform.scale = worldMat.GetScale();
+                        const TransformMatrixData* pParentMatrix = parent.get<TransformMatrixData>();
+                        if( pParentMatrix )
+                        {
+                            parentMat = pParentMatrix->transform;
+                            break;
+                        }
+                    }
 
-                        // This isn't working well.
-                        transform.rotation = worldMat.GetEulerAngles();
-                        m_pEditor_SelectedObject->GetEntity().modified<TransformData>();
+                    mat4 localMat = transform.GetLocalMatrix();
+                    worldMat = parentMat * localMat;
+
+                    if( ImGuizmo::Manipulate( &view.m11, &proj.m11, m_Editor_GizmoMode, ImGuizmo::MODE::LOCAL, &worldMat.m11, &deltaMat.m11 ) )
+                    {
+                        mat4 inverseParentMat = parentMat;
+                        inverseParentMat.Inverse();
+                        localMat = inverseParentMat * worldMat;
+
+                        transform.position = localMat.GetTranslation();
+                        transform.scale = localMat.GetScale();
+
+                        // Euler angles don't survive the round trip through a matrix well, so switch to a quaternion.
+                        transform.orientation = quat::CreateFromMatrix( localMat );
+                        transform.useQuaternion = true;
+                        transform.rotation = transform.orientation.GetEulerAngles();
+                        pSelectedObject->GetEntity().modified<TransformData>();
                     }
                 }
             }
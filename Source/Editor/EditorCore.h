@@ -11,6 +11,7 @@
 
 #include "GameCore.h"
 #include "Math/Vector.h"
+#include "Objects/GameObject.h"
 
 namespace fw {
 
@@ -25,7 +26,7 @@ class ResourceManager;
 class Scene;
 class Uniforms;
 
-enum EditorViews
+enum EditorViews : int
 {
     EditorView_Game,
     EditorView_Editor,
@@ -55,10 +56,11 @@ public:
     void Editor_DisplayObjectList();
     void Editor_ShowInspector();
     void Editor_ShowResources();
-    void Editor_SetSelectedObject(GameObject* pObject) { m_pEditor_SelectedObject = pObject; }
+    void Editor_ShowProfiler();
+    void Editor_SetSelectedObject(GameObject* pObject);
     void Editor_DrawGameView(int viewID);
     void Editor_DrawEditorView(int viewID);
-    GameObject* Editor_GetSelectedObject() { return m_pEditor_SelectedObject; }
+    GameObject* Editor_GetSelectedObject();
 
     ivec2 GetGameWindowSize() { return m_Game_WindowSize; }
     ivec2 GetEditorWindowSize() { return m_Editor_WindowSize; }
@@ -70,12 +72,14 @@ protected:
 
 protected:
     // Editor variables.
-    GameObject* m_pEditor_SelectedObject = nullptr;
+    // Held by handle, so it clears itself if the object is removed.
+    GameObjectHandle m_Editor_SelectedObject;
     EditorCamera* m_pEditorCamera = nullptr;
 
     // Windows/Focus.
     bool m_Editor_GameViewInFocus = false;
     bool m_Editor_EditorViewInFocus = false;
+    bool m_Editor_ShowProfiler = false;
 
     // Render to Texture
     ivec2 m_Game_WindowSize = vec2( 512, 512 );
@@ -12,6 +12,7 @@
 #include "EventManager.h"
 #include "Events.h"
 #include "GameCore.h"
+#include "Utility/AllocationTracker.h"
 
 namespace fw {
 
@@ -36,6 +37,8 @@ void EventManager::AddEvent(Event* pEvent, float32 delayBeforeSending)
 
 void EventManager::DispatchAllEvents(float32 deltaTime, GameCore* pGameCore)
 {
+    FW_ALLOC_TAG( AllocationTag::Events );
+
     if( m_EventQueue.empty() )
         return;
 
@@ -53,6 +56,7 @@ void EventManager::DispatchAllEvents(float32 deltaTime, GameCore* pGameCore)
         {
             // Send it to the game.
             pGameCore->OnEvent( pEvent );
+            m_NumEventsDispatched++;
 
             // Delete the event.
             delete pEvent;
@@ -23,8 +23,15 @@ public:
     void AddEvent(Event* pEvent, float32 delayBeforeSending = 0.0f);
     void DispatchAllEvents(float32 deltaTime, GameCore* pGameCore);
 
+    // Stats.
+    uint32 GetNumQueuedEvents() { return (uint32)m_EventQueue.size(); }
+    uint32 GetNumEventsDispatched() { return m_NumEventsDispatched; }
+    void ResetStats() { m_NumEventsDispatched = 0; }
+
 protected:
     std::queue<Event*> m_EventQueue;
+
+    uint32 m_NumEventsDispatched = 0;
 };
 
 } // namespace fw
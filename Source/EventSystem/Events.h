@@ -10,6 +10,7 @@
 #pragma once
 
 #include "Math/Vector.h"
+#include "Objects/GameObject.h"
 
 namespace fw {
 
@@ -24,7 +25,7 @@ class Event
 
 public:
     Event() {};
-    virtual ~Event() = 0 {};
+    virtual ~Event() {};
 
     virtual const char* GetType() = 0;
 
@@ -130,22 +131,26 @@ protected:
 //==========================
 // RemoveFromGame event class
 //==========================
+// Holds a handle rather than a pointer, so removing the same object twice is caught by the scene.
 class RemoveFromGameEvent : public Event
 {
 public:
     RemoveFromGameEvent(GameObject* pObject)
     {
-        m_pObject = pObject;
+        m_pScene = pObject->GetScene();
+        m_Handle = pObject->GetHandle();
     }
     virtual ~RemoveFromGameEvent() {}
 
     static const char* GetStaticEventType() { return "RemoveFromGameEvent"; }
     virtual const char* GetType() override { return GetStaticEventType(); }
 
-    GameObject* GetGameObject() { return m_pObject; }
+    Scene* GetScene() { return m_pScene; }
+    GameObjectHandle GetHandle() { return m_Handle; }
 
 protected:
-    GameObject* m_pObject;
+    Scene* m_pScene;
+    GameObjectHandle m_Handle;
 };
 
 } // namespace fw
@@ -9,178 +9,218 @@
 
 #include "CoreHeaders.h"
 
+#include <thread>
+
 #include "bgfx/platform.h"
 
 #include "FWCore.h"
 #include "GameCore.h"
 #include "EventSystem/Events.h"
 #include "EventSystem/EventManager.h"
+#include "Renderer/DebugDraw.h"
+#include "Renderer/FramePipeline.h"
+#include "Renderer/RenderSnapshot.h"
+#include "Resources/Mesh.h"
+#include "Utility/AllocationTracker.h"
+#include "Utility/Profiler.h"
 #include "Utility/Utility.h"
 
 namespace fw {
 
-// Initialize window on windows, huge chunks taken from nehe
-//    http://nehe.gamedev.net/tutorial/creating_an_opengl_window_%28win32%29/13001/
+// Platform independent parts of FWCore.
+// Window creation, the message pump and input collection live in the platform backends:
+//    Platform/FWCore_Win32.cpp
+//    Platform/FWCore_Headless.cpp
 
 // Public methods
 
-FWCore::FWCore(uint32 width, uint32 height, bgfx::RendererType::Enum renderType)
+uint32 FWCore::Run(GameCore& game)
 {
-    Init( width, height );
-
-    // Initialize bgfx.
-    bgfx::Init init;
-    
-    init.platformData.nwh = GetWindowHandle();
-    init.type = renderType;
-
-    init.resolution.width = width;
-    init.resolution.height = height;
-    init.resolution.reset = BGFX_RESET_VSYNC;
-
-    bool succeeded = bgfx::init( init );
-    assert( succeeded );
-
-    // Show the window.
-    ShowWindow( m_hWnd, SW_SHOW );   // Show the window.
-    SetForegroundWindow( m_hWnd );   // Slightly higher priority.
-    SetFocus( m_hWnd );              // Sets keyboard focus to the window.
-    ResizeWindow( width, height );   // Set up our screen.
-}
+    m_pGame = &game;
 
-FWCore::~FWCore()
-{
-    bgfx::shutdown();
-}
+    Profiler::SetThreadName( "Main" );
 
-bool FWCore::Init(uint32 width, uint32 height)
-{
-    m_WindowClientWidth = width;
-    m_WindowClientHeight = height;
+    double lastTime = GetSystemTimeSinceGameStart();
 
-    // Create our render window.
-    if( !FWCore::CreateRenderWindow( "My Window", width, height, 32, m_FullscreenMode ) )
+    // Main loop.
+    while( ProcessPlatformMessages() )
     {
-        PostQuitMessage( 0 );
-        return false;
-    }
+        FW_ALLOC_TAG( AllocationTag::Core );
+        Profiler::MarkFrame();
+        double frameStartTime = GetSystemTime();
 
-    return true;
-}
+        double currentTime = GetSystemTimeSinceGameStart();
+        m_RawDeltaTime = static_cast<float>( currentTime - lastTime );
+        lastTime = currentTime;
 
-uint32 FWCore::Run(GameCore& game)
-{
-    m_pGame = &game;
+        float deltaTime = SmoothDeltaTime( m_RawDeltaTime );
 
-    // Main loop.
-    MSG message;
-    bool done = false;
+        {
+            FW_PROFILE_SCOPE( "StartFrame" );
+            FrameStats::Timer timer( &m_FrameStats, FrameStat::StartFrame );
+            game.StartFrame( deltaTime );
+        }
 
-    double lastTime = GetSystemTimeSinceGameStart();
+        // Submit last frame's snapshot on the render thread while this frame updates.
+        if( m_pFramePipeline )
+        {
+            m_pFramePipeline->BeginSubmit( game.GetUniforms() );
+        }
 
-    while( !done )
-    {
-        if( PeekMessage( &message, nullptr, 0, 0, PM_REMOVE ) )
         {
-            if( message.message == WM_QUIT )
+            FW_PROFILE_SCOPE( "Update" );
+            FrameStats::Timer timer( &m_FrameStats, FrameStat::Update );
+            if( m_FixedTimestepEnabled )
             {
-                done = true;
+                UpdateFixedTimestep( game, deltaTime );
             }
             else
             {
-                TranslateMessage( &message );
-                DispatchMessage( &message );
+                game.Update( deltaTime );
             }
         }
-        else
+
+        // The render thread's encoder must be done before Draw touches any resources it uses or bgfx::frame is called.
+        if( m_pFramePipeline )
         {
-            double currentTime = GetSystemTimeSinceGameStart();
-            float deltaTime = static_cast<float>( currentTime - lastTime );
-            lastTime = currentTime;
+            FW_PROFILE_SCOPE( "WaitForSubmit" );
+            m_pFramePipeline->WaitForSubmit();
+        }
 
-            game.StartFrame( deltaTime );
-            game.Update( deltaTime );
+        {
+            FW_PROFILE_SCOPE( "Draw" );
+            FrameStats::Timer timer( &m_FrameStats, FrameStat::Draw );
             game.Draw();
+        }
+
+        {
+            FW_PROFILE_SCOPE( "EndFrame" );
+            FrameStats::Timer timer( &m_FrameStats, FrameStat::EndFrame );
             game.EndFrame();
+        }
 
-            // Swap buffers.
+        // Swap buffers.
+        {
+            FW_PROFILE_SCOPE( "bgfx::frame" );
+            FrameStats::Timer timer( &m_FrameStats, FrameStat::BGFXFrame );
             m_FrameCount = bgfx::frame();
+        }
+        m_FrameStats.GatherBGFXStats();
+
+        if( m_pFramePipeline )
+        {
+            m_pFramePipeline->SwapSnapshots();
+        }
+
+        // Drop debug shapes that weren't flushed this frame, so they don't pile up.
+        DebugDraw::Clear();
+
+        // Anything allocated from the arena last frame is released here, this frame's allocations survive until the next EndFrame.
+        m_FrameStats.SetValue( FrameStat::FrameArenaKB, (m_FrameArena.GetBytesUsed() + m_FrameArena.GetOverflowBytes()) / 1024.0f );
+        m_FrameArena.EndFrame();
 
-            // Backup the state of the keyboard and mouse.
-            for( int i=0; i<256; i++ )
-                m_OldKeyStates[i] = m_KeyStates[i];
+        // After the arena's EndFrame, so the copies made for the other buffers last as long as this frame's updates.
+        Mesh::SwapDynamicBuffers( &m_FrameArena );
 
-            for( int i=0; i<3; i++ )
-                m_OldMouseButtonStates[i] = m_MouseButtonStates[i];
+        // Backup the state of the keyboard and mouse.
+        for( int i=0; i<256; i++ )
+            m_OldKeyStates[i] = m_KeyStates[i];
 
-            m_MouseWheel = 0;
+        for( int i=0; i<3; i++ )
+            m_OldMouseButtonStates[i] = m_MouseButtonStates[i];
+
+        m_MouseWheel = 0;
+
+        {
+            FrameStats::Timer timer( &m_FrameStats, FrameStat::FramePacing );
+            WaitForNextFrame();
         }
+
+        AllocationTracker::MarkFrame();
+        AllocationTracker::Counts allocations = AllocationTracker::GetLastFrame();
+        m_FrameStats.SetValue( FrameStat::Allocations, (float)allocations.numAllocations );
+        m_FrameStats.SetValue( FrameStat::AllocatedKB, allocations.numBytes / 1024.0f );
+
+        m_FrameStats.SetValue( FrameStat::FrameTime, (float)( (GetSystemTime() - frameStartTime) * 1000.0 ) );
+        m_FrameStats.CommitFrame();
+
+        if( m_FrameLimit != 0 && static_cast<uint32>( m_FrameCount ) >= m_FrameLimit )
+            break;
     }
 
-    // Truncate wParam in 64-bit mode to an int.
-    return static_cast<uint32>( message.wParam );
+    if( m_HighResolutionSleepEnabled )
+    {
+        SetHighResolutionSleep( false );
+        m_HighResolutionSleepEnabled = false;
+    }
+
+    return m_ExitCode;
 }
 
-void FWCore::Shutdown()
+void FWCore::SetFixedTimestep(bool enabled, float timestep, uint32 maxSubsteps)
 {
-    m_pGame->OnShutdown();
-    DestroyRenderWindow( true );
-    PostQuitMessage(0);
+    assert( timestep > 0 );
+    assert( maxSubsteps > 0 );
+
+    m_FixedTimestepEnabled = enabled;
+    m_FixedTimestep = timestep;
+    m_MaxSubsteps = maxSubsteps;
+    m_TimestepAccumulator = 0.0f;
+    m_InterpolationAlpha = 1.0f;
 }
 
-void FWCore::SetWindowSize(uint32 width, uint32 height)
+void FWCore::SetDeltaTimeSmoothing(uint32 numFrames)
 {
-    SetWindowPositionAndSize( 0, 0, width, height, false );
+    assert( numFrames > 0 && numFrames <= c_MaxDeltaTimeSamples );
+
+    m_DeltaTimeSmoothingFrames = std::clamp<uint32>( numFrames, 1, c_MaxDeltaTimeSamples );
+    m_DeltaTimeSampleIndex = 0;
+    m_NumDeltaTimeSamples = 0;
 }
 
-void FWCore::SetWindowPositionAndSize(int32 x, int32 y, uint32 width, uint32 height, bool maximized)
+void FWCore::SetPipelinedRendering(bool enabled)
 {
-    SetWindowPos( m_hWnd, nullptr, x, y, width, height, 0 );
-    if( maximized )
+    if( enabled && m_pFramePipeline == nullptr )
     {
-        ShowWindow( m_hWnd, SW_MAXIMIZE );
+        m_pFramePipeline = new FramePipeline( &m_FrameArena );
+    }
+    else if( enabled == false && m_pFramePipeline )
+    {
+        delete m_pFramePipeline;
+        m_pFramePipeline = nullptr;
     }
-    RECT clientRect;
-    GetClientRect( m_hWnd, &clientRect );
-    ResizeWindow( clientRect.right - clientRect.left, clientRect.bottom - clientRect.top );
 }
 
-void FWCore::SetClientPositionAndSize(int32 x, int32 y, uint32 width, uint32 height, bool maximized)
+uint32 FWCore::GetNumWorkerThreads()
 {
-    uint32 maxWidth = GetSystemMetrics( SM_CXFULLSCREEN );
-    uint32 maxHeight = GetSystemMetrics( SM_CYFULLSCREEN );
-
-    float aspect = static_cast<float>( width ) / height;
+    if( m_NumWorkerThreads == 0 )
+        return std::max( std::thread::hardware_concurrency(), 1u );
 
-    if( width > maxWidth )
-    {
-        width = maxWidth;
-        height = static_cast<uint32>(maxWidth / aspect);
-    }
+    return m_NumWorkerThreads;
+}
 
-    if( height > maxHeight )
+enki::TaskScheduler* FWCore::GetTaskScheduler()
+{
+    if( m_pTaskScheduler == nullptr )
     {
-        width = static_cast<uint32>(maxHeight * aspect);
-        height = maxHeight;
+        m_pTaskScheduler = new enki::TaskScheduler;
+        m_pTaskScheduler->Initialize( GetNumWorkerThreads() );
     }
 
-    DWORD dwStyle = static_cast<DWORD>( GetWindowLongPtr( m_hWnd, GWL_STYLE ) );
-    DWORD dwExStyle = static_cast<DWORD>( GetWindowLongPtr( m_hWnd, GWL_EXSTYLE ) );
-    HMENU menu = GetMenu( m_hWnd );
+    return m_pTaskScheduler;
+}
 
-    // Calculate the full size of the window needed to match our client area of width/height.
-    RECT WindowRect = { 0, 0, (int32)width, (int32)height };
-    AdjustWindowRectEx( &WindowRect, dwStyle, menu ? TRUE : FALSE, dwExStyle );
+RenderSnapshot* FWCore::GetRenderSnapshot()
+{
+    if( m_pFramePipeline == nullptr )
+        return nullptr;
 
-    int windowWidth = WindowRect.right - WindowRect.left;
-    int windowHeight = WindowRect.bottom - WindowRect.top;
+    return m_pFramePipeline->GetWriteSnapshot();
+}
 
-    SetWindowPos( m_hWnd, 0, x, y, windowWidth, windowHeight, 0 );
-    if( maximized )
-    {
-        ShowWindow( m_hWnd, SW_MAXIMIZE );
-    }
-    ResizeWindow( width, height );
+void FWCore::SetWindowSize(uint32 width, uint32 height)
+{
+    SetWindowPositionAndSize( 0, 0, width, height, false );
 }
 
 bool FWCore::IsKeyDown(uint32 value)
@@ -195,19 +235,6 @@ bool FWCore::IsMouseButtonDown(uint32 id)
     return m_MouseButtonStates[id];
 }
 
-void FWCore::GetMouseCoordinates(int32* mx, int32* my)
-{
-    POINT p;
-    if( GetCursorPos( &p ) )
-    {
-        if( ScreenToClient( m_hWnd, &p ) )
-        {
-            *mx = p.x;
-            *my = p.y;
-        }
-    }
-}
-
 float FWCore::GetMouseWheel()
 {
     return m_MouseWheel;
@@ -220,374 +247,137 @@ vec2 FWCore::GetMouseDir()
 
 // Protected methods.
 
-void FWCore::ResizeWindow(uint32 width, uint32 height)
+void FWCore::UpdateFixedTimestep(GameCore& game, float deltaTime)
 {
-    if( height <= 0 ) height = 1;
-    if( width <= 0 ) width = 1;
-
-    m_WindowClientWidth = width;
-    m_WindowClientHeight = height;
+    m_TimestepAccumulator += deltaTime;
 
-    bgfx::reset( width, height, BGFX_RESET_VSYNC );
-    //bgfx::setViewRect( 0, 0, 0, width, height );
+    uint32 numSteps = 0;
+    while( m_TimestepAccumulator >= m_FixedTimestep && numSteps < m_MaxSubsteps )
+    {
+        game.Update( m_FixedTimestep );
+        m_TimestepAccumulator -= m_FixedTimestep;
+        numSteps++;
+    }
 
-    if( m_pGame )
+    // If we hit the substep limit, drop the time we couldn't simulate.
+    // Otherwise a slow frame causes more steps next frame, which causes a slower frame, etc.
+    if( m_TimestepAccumulator >= m_FixedTimestep )
     {
-        WindowResizeEvent* pEvent = new WindowResizeEvent( width, height );
-        m_pGame->GetEventManager()->AddEvent( pEvent );
+        m_TimestepAccumulator = fmodf( m_TimestepAccumulator, m_FixedTimestep );
     }
+
+    m_InterpolationAlpha = m_TimestepAccumulator / m_FixedTimestep;
 }
 
-bool FWCore::CreateRenderWindow(const char* title, uint32 width, uint32 height, uint8 colorBits, bool fullscreenflag)
+float FWCore::SmoothDeltaTime(float deltaTime)
 {
-    DWORD dwExStyle;
-    DWORD dwStyle;
+    if( m_DeltaTimeSmoothingFrames <= 1 )
+        return deltaTime;
 
-    RECT WindowRect;
-    WindowRect.left = (long)0;
-    WindowRect.right = (long)width;
-    WindowRect.top = (long)0;
-    WindowRect.bottom = (long)height;
+    m_DeltaTimeSamples[m_DeltaTimeSampleIndex] = deltaTime;
+    m_DeltaTimeSampleIndex = (m_DeltaTimeSampleIndex + 1) % m_DeltaTimeSmoothingFrames;
+    if( m_NumDeltaTimeSamples < m_DeltaTimeSmoothingFrames )
+        m_NumDeltaTimeSamples++;
 
-    m_FullscreenMode = fullscreenflag;
+    float total = 0;
+    for( uint32 i=0; i<m_NumDeltaTimeSamples; i++ )
+        total += m_DeltaTimeSamples[i];
 
-    m_hInstance = GetModuleHandle( nullptr );       // Grab an instance for our window.
+    return total / m_NumDeltaTimeSamples;
+}
 
-    // Define and register the window class.
-    {
-        WNDCLASSEX wc;
-        ZeroMemory( &wc, sizeof(wc) );
-        wc.cbSize = sizeof( wc );
-
-        wc.style = CS_HREDRAW | CS_VREDRAW | CS_OWNDC;  // Redraw on move, and own DC for window.
-        wc.lpfnWndProc = (WNDPROC)FWCore::WndProc;      // WndProc handles messages.
-        wc.cbClsExtra = 0;                              // No extra window data.
-        wc.cbWndExtra = 0;                              // No extra window data.
-        wc.hInstance = m_hInstance;                     // Set the instance.
-        wc.hIcon = LoadIcon( 0, IDI_WINLOGO );          // Load the default icon.
-        wc.hCursor = LoadCursor( 0, IDC_ARROW );        // Load the arrow pointer.
-        wc.hbrBackground = 0;                           // No background required.
-        wc.lpszMenuName = nullptr;                      // We don't want a menu.
-        wc.lpszClassName = "MyWindowClass";             // Set the class name.
-
-        // Attempt to register the Window Class.
-        if( !RegisterClassEx( &wc ) )
-        {
-            return FailAndCleanup( "Failed To Register The Window Class." );
-        }
-    }
+void FWCore::WaitForNextFrame()
+{
+    FW_PROFILE_SCOPE( "WaitForNextFrame" );
+
+    float frameRate = m_TargetFrameRate;
+    if( m_WindowIsActive == false && m_BackgroundFrameRate > 0 )
+        frameRate = m_BackgroundFrameRate;
 
-    if( m_FullscreenMode )
+    if( frameRate <= 0 )
+        return;
+
+    if( m_HighResolutionSleepEnabled == false )
     {
-        DEVMODE dmScreenSettings;                                   // Device mode.
-        memset( &dmScreenSettings, 0, sizeof( dmScreenSettings ) ); // Makes sure memory's cleared.
-        dmScreenSettings.dmSize = sizeof( dmScreenSettings );       // Size of the devmode structure.
-        dmScreenSettings.dmPelsWidth  = width;                      // Selected screen width.
-        dmScreenSettings.dmPelsHeight = height;                     // Selected screen height.
-        dmScreenSettings.dmBitsPerPel = colorBits;                  // Selected bits per pixel.
-        dmScreenSettings.dmFields = DM_BITSPERPEL | DM_PELSWIDTH | DM_PELSHEIGHT;
-
-        // Try to set selected mode and get results.  NOTE: CDS_FULLSCREEN gets rid of start bar.
-        if( ChangeDisplaySettings( &dmScreenSettings, CDS_FULLSCREEN ) != DISP_CHANGE_SUCCESSFUL )
-        {
-            // If the mode fails, offer two options.  Quit or run in a window.
-            if( MessageBox( 0, "The requested fullscreen mode is not supported by\nyour video card.\nTry a different resolution.\nUse Windowed Mode Instead?", "", MB_YESNO|MB_ICONEXCLAMATION ) == IDYES )
-            {
-                m_FullscreenMode = false;
-            }
-            else
-            {
-                //return FailAndCleanup( "Program Will Now Close." );
-                return false;
-            }
-        }
+        SetHighResolutionSleep( true );
+        m_HighResolutionSleepEnabled = true;
     }
 
-    if( m_FullscreenMode )
+    // Step the target time by a fixed amount so small errors don't accumulate into drift.
+    // If we're running behind, don't try to catch up, just start pacing from now.
+    double currentTime = GetSystemTimeSinceGameStart();
+    m_NextFrameTime += 1.0 / frameRate;
+    if( m_NextFrameTime < currentTime )
     {
-        dwExStyle = WS_EX_APPWINDOW;
-        dwStyle = WS_POPUP;
-        ShowCursor( false );
+        m_NextFrameTime = currentTime;
+        return;
     }
-    else
+
+    // Sleep for most of the remaining time.
+    double sleepTime = m_NextFrameTime - currentTime - m_SleepOvershoot;
+    if( sleepTime > 0 )
     {
-        dwExStyle = WS_EX_APPWINDOW | WS_EX_WINDOWEDGE;
-        dwStyle = WS_OVERLAPPEDWINDOW;
+        SleepSeconds( sleepTime );
+
+        // Track how late the OS wakes us up, the spin below needs to cover that much.
+        // Grow immediately on a late wake up, shrink slowly.
+        double timeAfterSleep = GetSystemTimeSinceGameStart();
+        double overshoot = (timeAfterSleep - currentTime) - sleepTime;
+        if( overshoot > m_SleepOvershoot )
+            m_SleepOvershoot = overshoot;
+        else
+            m_SleepOvershoot = m_SleepOvershoot * 0.95 + overshoot * 0.05;
+        m_SleepOvershoot = std::clamp( m_SleepOvershoot, 0.0005, 0.02 );
     }
 
-    AdjustWindowRectEx( &WindowRect, dwStyle, false, dwExStyle );   // Adjust window to true requested size.
-
-    // Create our window.
+    // Spin for the rest.
+    while( GetSystemTimeSinceGameStart() < m_NextFrameTime )
     {
-        m_hWnd = CreateWindowEx( dwExStyle,           // Extended style for the window.
-                 "MyWindowClass",                     // Class name.
-                 title,                               // Window title.
-                 WS_CLIPSIBLINGS | WS_CLIPCHILDREN |  // Required window style.
-                 dwStyle,                             // Selected window style.
-                 0, 0,                                // Window position.
-                 WindowRect.right-WindowRect.left,    // Calculate adjusted window width.
-                 WindowRect.bottom-WindowRect.top,    // Calculate adjusted window height.
-                 nullptr,                             // No parent window.
-                 nullptr,                             // No menu.
-                 m_hInstance,                         // Instance.
-                 this );                              // Pass a pointer to this FWCore object to WM_NCCREATE.
-        
-        if( m_hWnd == nullptr )
-        {
-            return FailAndCleanup( "Window Creation Error." );
-        }
     }
-
-    return true;
 }
 
-bool FWCore::FailAndCleanup(const char* pMessage)
+void FWCore::ResizeWindow(uint32 width, uint32 height)
 {
-    DestroyRenderWindow( true );
-    MessageBox( 0, pMessage, "ERROR", MB_OK|MB_ICONEXCLAMATION );
-    return false;
-}
+    if( height <= 0 ) height = 1;
+    if( width <= 0 ) width = 1;
 
-void FWCore::DestroyRenderWindow(bool destroyInstance)
-{
-    if( m_FullscreenMode )
+    m_WindowClientWidth = width;
+    m_WindowClientHeight = height;
+
+    bgfx::reset( width, height, m_ResetFlags );
+    //bgfx::setViewRect( 0, 0, 0, width, height );
+
+    if( m_pGame )
     {
-        ChangeDisplaySettings( nullptr, 0 );
-        ShowCursor( true );
+        WindowResizeEvent* pEvent = new WindowResizeEvent( width, height );
+        m_pGame->GetEventManager()->AddEvent( pEvent );
     }
+}
+
+void FWCore::SetViewTransform(int viewID, const mat4& viewMatrix, const mat4& projMatrix)
+{
+    assert( viewID >= 0 && viewID < c_MaxViews );
 
-    if( m_hWnd && !DestroyWindow( m_hWnd ) )
+    RenderSnapshot* pSnapshot = GetRenderSnapshot();
+    if( pSnapshot )
     {
-        MessageBox( 0, "Could Not Release hWnd.", "SHUTDOWN ERROR", MB_OK | MB_ICONINFORMATION );
+        pSnapshot->SetViewTransform( viewID, viewMatrix, projMatrix );
     }
-
-    if( destroyInstance && m_hInstance != nullptr )
+    else
     {
-        if( !UnregisterClass( "MyWindowClass", m_hInstance ) )
-        {
-            MessageBox( 0, "Could Not Unregister Class.", "SHUTDOWN ERROR", MB_OK | MB_ICONINFORMATION );
-        }
-        m_hInstance = 0;
+        bgfx::setViewTransform( viewID, &viewMatrix.m11, &projMatrix.m11 );
     }
 
-    m_hWnd = 0;
+    m_ViewProjections[viewID].viewProj = projMatrix * viewMatrix;
+    m_ViewProjections[viewID].frame = m_FrameCount;
 }
 
-// This is a static method.
-LRESULT CALLBACK FWCore::WndProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
+const mat4* FWCore::GetViewProjection(int viewID)
 {
-    //!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! WARNING !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-    //!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! READ THIS !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-    // This is a static method, which means it's essentially a global function.
-    // It has no "this".
-    // That means you can't access variables and methods directly.
-    // As a member of the FWCore class it has full access to private
-    //     variables and methods of any instance of the class.
-    // To access the single instance of FWCore that we created
-    //     you have to use the pFWCore pointer initialized just below.
-    //!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-
-    // Get a pointer to the FWCore object associated with this window.
-    FWCore* pFWCore = (FWCore*)GetWindowLongPtr( hWnd, GWLP_USERDATA );
-
-    switch( uMsg )
-    {
-    case WM_NCCREATE:
-        {
-            // Set the user data for this hWnd to the FWCore* we passed in, used on first line of this method above.
-            CREATESTRUCT* pCreateStruct = reinterpret_cast<CREATESTRUCT*>( lParam );
-            FWCore* pFWCore = static_cast<FWCore*>( pCreateStruct->lpCreateParams );
-            SetWindowLongPtr( hWnd, GWLP_USERDATA, reinterpret_cast<LONG_PTR>( pFWCore ) );
-
-            if( pFWCore )
-            {
-                pFWCore->m_hWnd = hWnd;
-            }
-        }
-        return 1;
-
-    case WM_DESTROY:
-        {
-            if( pFWCore )
-            {
-                pFWCore->m_hWnd = nullptr;
-            }
-        }
-        return 0;
-
-    case WM_ACTIVATE:
-        {
-            if( !HIWORD(wParam) )
-            {
-                pFWCore->m_WindowIsActive = true;
-            }
-            else
-            {
-                pFWCore->m_WindowIsActive = false;
-            } 
-        }
-        return 0;
-
-    case WM_SYSCOMMAND:
-        {
-            switch( wParam )
-            {
-            // Don't let screensaver or monitor power save mode kick in.
-            case SC_SCREENSAVE:
-            case SC_MONITORPOWER:
-                return 0;
-            }
-        }
-        break;
-
-    case WM_CLOSE:
-        {
-            PostQuitMessage( 0 );
-        }
-        return 0;
-
-    case WM_CHAR:
-        {
-            // Send a char event to the event manager.
-            OnCharEvent* pEvent = new OnCharEvent( (uint32)wParam );
-            pFWCore->m_pGame->GetEventManager()->AddEvent( pEvent );
-        }
-        return 0;
-
-    case WM_KEYDOWN:
-        {
-            bool keyWasPressedLastTimeMessageArrived = lParam & (1 << 30);
-
-            if( keyWasPressedLastTimeMessageArrived == false )
-            {
-                if( wParam == VK_ESCAPE && pFWCore->m_EscapeKeyWillQuit )
-                    PostQuitMessage( 0 );
-
-                pFWCore->m_KeyStates[wParam] = true;
-
-                // Send a input event to the event manager.
-                InputEvent* pEvent = new InputEvent( InputEvent::DeviceType::Keyboard, InputEvent::DeviceState::Pressed, (uint32)wParam );
-                pFWCore->m_pGame->GetEventManager()->AddEvent( pEvent );
-            }
-        }
-        return 0;
-
-    case WM_KEYUP:
-        {
-            pFWCore->m_KeyStates[wParam] = false;
-    
-            // Send a input event to the event manager.
-            InputEvent* pEvent = new InputEvent( InputEvent::DeviceType::Keyboard, InputEvent::DeviceState::Released, (uint32)wParam );
-            pFWCore->m_pGame->GetEventManager()->AddEvent( pEvent );
-        }
-        return 0;
-
-    case WM_MOUSEMOVE:
-        {
-            int x = GET_X_LPARAM( lParam );
-            int y = GET_Y_LPARAM( lParam );
-            
-            if( pFWCore->m_MouseButtonStates[1] == true )
-            {
-                POINT pt = { (int)pFWCore->m_MouseDownLocation[1].x, (int)pFWCore->m_MouseDownLocation[1].y };
-                ClientToScreen( hWnd, &pt );
-                SetCursorPos( pt.x, pt.y );
-            }
-            vec2 mouseDir = pFWCore->m_MouseDownLocation[1] - vec2( x, y );
-            pFWCore->m_MouseDir = mouseDir;
-            
-            // Send a input event to the event manager.
-            InputEvent* pEvent = new InputEvent( InputEvent::DeviceType::Mouse, InputEvent::DeviceState::Moved, -1, mouseDir );
-            pFWCore->m_pGame->GetEventManager()->AddEvent( pEvent );
-        }
-        return 0;
-
-    case WM_LBUTTONDOWN:
-        {
-            SetCapture( pFWCore->m_hWnd );
-
-            pFWCore->m_MouseButtonStates[0] = true;
-
-            int x = GET_X_LPARAM( lParam );
-            int y = GET_Y_LPARAM( lParam );
-        }
-        return 0;
-
-    case WM_LBUTTONUP:
-        {
-            ReleaseCapture();
-        
-            pFWCore->m_MouseButtonStates[0] = false;
-
-            int x = GET_X_LPARAM( lParam );
-            int y = GET_Y_LPARAM( lParam );
-        }
-        return 0;
-
-    case WM_RBUTTONDOWN:
-        {
-            SetCapture( pFWCore->m_hWnd );
-
-            pFWCore->m_MouseButtonStates[1] = true;
-
-            int x = GET_X_LPARAM( lParam );
-            int y = GET_Y_LPARAM( lParam );
-            pFWCore->m_MouseDownLocation[1].Set( x, y );
-            vec2 mouseDir( 0, 0 );
-            pFWCore->m_MouseDir = mouseDir;
-
-            // Send a input event to the event manager.
-            InputEvent* pEvent = new InputEvent( InputEvent::DeviceType::Mouse, InputEvent::DeviceState::Pressed, 1, mouseDir );
-            pFWCore->m_pGame->GetEventManager()->AddEvent( pEvent );
-        }
-        return 0;
-
-    case WM_RBUTTONUP:
-        {
-            ReleaseCapture();
-
-            pFWCore->m_MouseButtonStates[1] = false;
-
-            vec2 mouseDir( 0, 0 );
-            pFWCore->m_MouseDir = mouseDir;
-            
-            // Send a input event to the event manager.
-            InputEvent* pEvent = new InputEvent( InputEvent::DeviceType::Mouse, InputEvent::DeviceState::Released, 1, mouseDir );
-            pFWCore->m_pGame->GetEventManager()->AddEvent( pEvent );
-        }
-        return 0;
-
-    case WM_MBUTTONDOWN:
-        {
-            SetCapture( pFWCore->m_hWnd );
-
-            pFWCore->m_MouseButtonStates[2] = true;
-        }
-        return 0;
-
-    case WM_MBUTTONUP:
-        {
-            ReleaseCapture();
-
-            pFWCore->m_MouseButtonStates[2] = false;
-        }
-        return 0;
-
-    case WM_MOUSEWHEEL:
-        {
-            pFWCore->m_MouseWheel = GET_WHEEL_DELTA_WPARAM(wParam) / 120.0f;
-        }
-        return 0;
-
-    case WM_SIZE:
-        {
-            pFWCore->ResizeWindow( LOWORD(lParam), HIWORD(lParam) );
-        }
-        return 0;
-    }
+    if( viewID < 0 || viewID >= c_MaxViews || m_ViewProjections[viewID].frame != m_FrameCount )
+        return nullptr;
 
-    // Pass all unhandled messages to DefWindowProc.
-    return DefWindowProc( hWnd, uMsg, wParam, lParam );
+    return &m_ViewProjections[viewID].viewProj;
 }
 
 } // namespace fw
@@ -11,6 +11,9 @@
 
 #include "bgfx/platform.h"
 #include "Math/Vector.h"
+#include "Math/Matrix.h"
+#include "Utility/FrameArena.h"
+#include "Utility/FrameStats.h"
 
 namespace fw {
 
@@ -34,21 +37,91 @@ public:
     float GetMouseWheel();
     vec2 GetMouseDir();
 
+#if FW_HEADLESS
+    void* GetWindowHandle() { return nullptr; }
+#else
     HWND GetWindowHandle() { return m_hWnd; }
+#endif
     uint32 GetWindowClientWidth() { return m_WindowClientWidth; }
     uint32 GetWindowClientHeight() { return m_WindowClientHeight; }
 
     void SetEscapeKeyWillQuit(bool value) { m_EscapeKeyWillQuit = value; }
+    void SetFrameLimit(uint32 numFrames) { m_FrameLimit = numFrames; }
 
     uint32 GetFrameCount() { return m_FrameCount; }
+    FrameStats* GetFrameStats() { return &m_FrameStats; }
+    FrameArena* GetFrameArena() { return &m_FrameArena; }
+
+    // Fixed timestep.
+    // When enabled, GameCore::Update is called zero or more times per frame with a constant deltaTime.
+    // StartFrame and Draw still run once per frame, Draw can use the interpolation alpha
+    //   to blend between the previous and current simulation states.
+    void SetFixedTimestep(bool enabled, float timestep = 1.0f/60.0f, uint32 maxSubsteps = 5);
+    bool IsFixedTimestepEnabled() { return m_FixedTimestepEnabled; }
+    float GetFixedTimestep() { return m_FixedTimestep; }
+    float GetInterpolationAlpha() { return m_InterpolationAlpha; }
+
+    // Frame pacing.
+    // A target frame rate of 0 runs uncapped, the background rate is used while the window isn't active.
+    // Waiting sleeps for most of the frame, then spins for the remainder to hit the target time accurately.
+    // Delta time smoothing averages the last numFrames frame times, 1 disables it.
+    void SetTargetFrameRate(float framesPerSecond) { m_TargetFrameRate = framesPerSecond; }
+    void SetBackgroundFrameRate(float framesPerSecond) { m_BackgroundFrameRate = framesPerSecond; }
+    void SetDeltaTimeSmoothing(uint32 numFrames);
+    float GetTargetFrameRate() { return m_TargetFrameRate; }
+    float GetBackgroundFrameRate() { return m_BackgroundFrameRate; }
+    float GetRawDeltaTime() { return m_RawDeltaTime; }
+
+    // Worker threads for multithreaded flecs systems and the task scheduler, 0 uses one per hardware thread.
+    // Read when a Scene or the task scheduler is created, so set this before either.
+    void SetNumWorkerThreads(uint32 numThreads) { m_NumWorkerThreads = numThreads; }
+    uint32 GetNumWorkerThreads();
+    // Created on first use, the thread waiting on a task also runs its work.
+    enki::TaskScheduler* GetTaskScheduler();
+
+    // Parallel submission.
+    // When enabled, scenes drawn without pipelined rendering split their draw list into chunks
+    //   and submit each one on a task scheduler thread through its own bgfx encoder.
+    void SetParallelSubmission(bool enabled) { m_ParallelSubmissionEnabled = enabled; }
+    bool IsParallelSubmissionEnabled() { return m_ParallelSubmissionEnabled; }
+
+    // Meshes switching LODs draw both for this many seconds with a dithered cross-fade, 0 switches instantly.
+    // Shaders need to read u_LODFade for this, see Mesh::Draw.
+    void SetLODFadeDuration(float seconds) { m_LODFadeDuration = seconds; }
+    float GetLODFadeDuration() { return m_LODFadeDuration; }
+
+    // Pipelined rendering.
+    // When enabled, scene draws are recorded into a RenderSnapshot during Draw and submitted
+    //   on a render thread while the next frame's Update runs, adding a frame of latency to the scene.
+    // ImGui and anything else drawing directly through bgfx is unaffected.
+    void SetPipelinedRendering(bool enabled);
+    bool IsPipelinedRenderingEnabled() { return m_pFramePipeline != nullptr; }
+    RenderSnapshot* GetRenderSnapshot();
+
+    // View transforms.
+    // Sets a view's matrices through bgfx, or records them in the snapshot with pipelined rendering.
+    // The combined view projection is kept until the end of the frame so scenes can cull against it.
+    void SetViewTransform(int viewID, const mat4& viewMatrix, const mat4& projMatrix);
+    // Returns nullptr if the view's transform wasn't set this frame.
+    const mat4* GetViewProjection(int viewID);
 
 protected:
+    // Implemented by each platform backend, returns false once the app should quit.
+    bool ProcessPlatformMessages();
+
+    void UpdateFixedTimestep(GameCore& game, float deltaTime);
+    float SmoothDeltaTime(float deltaTime);
+    void WaitForNextFrame();
+
     void ResizeWindow(uint32 width, uint32 height);
+
+#if !FW_HEADLESS
     bool CreateRenderWindow(const char* title, uint32 width, uint32 height, uint8 colorBits, bool fullscreenflag);
     bool FailAndCleanup(const char* pMessage);
     void DestroyRenderWindow(bool destroyInstance);
 
     static LRESULT CALLBACK WndProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
+#endif
 
 protected:
     GameCore* m_pGame = nullptr;
@@ -57,9 +130,14 @@ protected:
 
     uint32 m_WindowClientWidth = 0;
     uint32 m_WindowClientHeight = 0;
+    uint32 m_ResetFlags = BGFX_RESET_NONE; // Set by the platform's constructor, reused when resizing.
 
+#if FW_HEADLESS
+    bool m_QuitRequested = false;
+#else
     HWND m_hWnd = nullptr;
     HINSTANCE m_hInstance = nullptr;
+#endif
 
     bool m_KeyStates[256] = {};
     bool m_MouseButtonStates[3] = {};
@@ -73,6 +151,49 @@ protected:
     vec2 m_MouseDir = {};
 
     int32 m_FrameCount = 0;
+    uint32 m_FrameLimit = 0; // 0 means run until quit.
+    uint32 m_ExitCode = 0;
+
+    FrameStats m_FrameStats;
+    FrameArena m_FrameArena;
+
+    // Fixed timestep.
+    bool m_FixedTimestepEnabled = false;
+    float m_FixedTimestep = 1.0f/60.0f;
+    uint32 m_MaxSubsteps = 5;
+    float m_TimestepAccumulator = 0.0f;
+    float m_InterpolationAlpha = 1.0f;
+
+    // Frame pacing.
+    static const uint32 c_MaxDeltaTimeSamples = 16;
+    float m_TargetFrameRate = 0; // 0 means uncapped.
+    float m_BackgroundFrameRate = 0; // 0 means use the target frame rate.
+    double m_NextFrameTime = 0;
+    double m_SleepOvershoot = 0.002; // Adjusted based on how late the OS wakes us up.
+    bool m_HighResolutionSleepEnabled = false;
+    float m_RawDeltaTime = 0;
+    float m_DeltaTimeSamples[c_MaxDeltaTimeSamples] = {};
+    uint32 m_DeltaTimeSmoothingFrames = 1;
+    uint32 m_DeltaTimeSampleIndex = 0;
+    uint32 m_NumDeltaTimeSamples = 0;
+
+    // Jobs.
+    uint32 m_NumWorkerThreads = 0;
+    enki::TaskScheduler* m_pTaskScheduler = nullptr;
+    bool m_ParallelSubmissionEnabled = false;
+    float m_LODFadeDuration = 0;
+
+    // Pipelined rendering.
+    FramePipeline* m_pFramePipeline = nullptr;
+
+    // View transforms.
+    static const int c_MaxViews = 256;
+    struct ViewProjection
+    {
+        mat4 viewProj;
+        int32 frame = -1;
+    };
+    ViewProjection m_ViewProjections[c_MaxViews];
 };
 
 } // namespace fw
@@ -24,22 +24,32 @@ namespace fw
     class ComponentManager;
     class EditorCamera;
     class EditorCore;
+    class FrameArena;
+    class FramePipeline;
+    class FrameStats;
     class FWCore;
     class GameCore;
     class GameObject;
     class ImGuiManager;
+    class MappedFile;
     class Material;
     class Mesh;
+    class PerfectHashTable;
+    class RenderSnapshot;
     class Resource;
     class ResourceManager;
     class Scene;
     class ShaderProgram;
+    class SpriteBatch;
     class SpriteSheet;
     class Texture;
+    class TransientMeshBuilder;
     class Uniforms;
 
     // Math.
+    class Frustum;
     class mat4;
+    class quat;
     class vec2;
     class vec3;
     class vec4;
@@ -67,12 +77,14 @@ namespace fw
     struct NameData;
     struct TransformData;
     struct MeshData;
+    struct SpriteData;
 
     class NameComponentDefinition;
     class TransformComponentDefinition;
     class MeshComponentDefinition;
+    class SpriteComponentDefinition;
 
     // Enums.
-    enum EditorViews;
+    enum EditorViews : int;
     enum class ResourceType;
 } // namespace fw
@@ -25,22 +25,38 @@
 #include "GameCore.h"
 #include "Components/ComponentManager.h"
 #include "Components/CoreComponents.h"
+#include "Components/CoreSystems.h"
 #include "Editor/EditorCore.h"
 #include "EventSystem/Events.h"
 #include "EventSystem/EventManager.h"
 #include "Imgui/ImGuiManager.h"
+#include "Math/Frustum.h"
 #include "Math/MathHelpers.h"
 #include "Math/MathOps.h"
 #include "Math/Matrix.h"
+#include "Math/Quaternion.h"
 #include "Math/Random.h"
 #include "Objects/Camera.h"
 #include "Objects/GameObject.h"
+#include "Renderer/DebugDraw.h"
+#include "Renderer/FramePipeline.h"
+#include "Renderer/RenderSnapshot.h"
+#include "Renderer/SpriteBatch.h"
+#include "Renderer/TransientMeshBuilder.h"
 #include "Renderer/Uniforms.h"
 #include "Resources/Material.h"
 #include "Resources/Mesh.h"
+#include "Resources/MeshFormat.h"
 #include "Resources/ResourceManager.h"
 #include "Resources/ShaderProgram.h"
 #include "Resources/SpriteSheet.h"
 #include "Resources/Texture.h"
 #include "Scenes/Scene.h"
+#include "Utility/AllocationTracker.h"
+#include "Utility/FrameArena.h"
+#include "Utility/FrameStats.h"
+#include "Utility/MappedFile.h"
+#include "Utility/ObjectPool.h"
+#include "Utility/PerfectHash.h"
+#include "Utility/Profiler.h"
 #include "Utility/Utility.h"
@@ -8,6 +8,7 @@
 // 3. This notice may not be removed or altered from any source distribution.
 
 #include "CoreHeaders.h"
+#include "FWCore.h"
 #include "GameCore.h"
 #include "Components/ComponentManager.h"
 #include "Components/CoreComponents.h"
@@ -19,7 +20,9 @@
 #include "Renderer/Uniforms.h"
 #include "Resources/Material.h"
 #include "Resources/Mesh.h"
+#include "Resources/ResourceManager.h"
 #include "Scenes/Scene.h"
+#include "Utility/AllocationTracker.h"
 #include "Utility/Utility.h"
 
 namespace fw {
@@ -50,6 +53,7 @@ Scene* GameCore::CreateScene()
 
 void GameCore::StartFrame(float deltaTime)
 {
+    FW_ALLOC_TAG( AllocationTag::Editor );
     m_pImGuiManager->StartFrame( deltaTime );
     //ImGui::ShowDemoWindow();
 }
@@ -88,6 +92,30 @@ void GameCore::Draw()
 
 void GameCore::EndFrame()
 {
+    // Framework counters, the rest of the stats are gathered by FWCore.
+    FrameStats* pStats = m_FWCore.GetFrameStats();
+    if( m_pActiveScene )
+    {
+        pStats->SetValue( FrameStat::GameObjects, (float)m_pActiveScene->GetNumGameObjects() );
+        pStats->SetValue( FrameStat::Entities, (float)m_pActiveScene->GetFlecsWorld().count<TransformData>() );
+    }
+    if( m_pResources )
+    {
+        pStats->SetValue( FrameStat::Resources, (float)m_pResources->GetNumResources() );
+    }
+    if( m_pEventManager )
+    {
+        pStats->SetValue( FrameStat::EventsDispatched, (float)m_pEventManager->GetNumEventsDispatched() );
+        pStats->SetValue( FrameStat::EventsQueued, (float)m_pEventManager->GetNumQueuedEvents() );
+        m_pEventManager->ResetStats();
+    }
+
+    FW_ALLOC_TAG( AllocationTag::Editor );
+    if( m_ShowDebugStats )
+    {
+        pStats->Editor_DisplayOverlay( &m_ShowDebugStats );
+    }
+
     m_pImGuiManager->EndFrame();
 }
 
@@ -49,6 +49,7 @@ void ImGuiManager::Init(int viewID)
     io.IniFilename = "imgui.ini";
     io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
 
+#if FW_PLATFORM_WINDOWS
     // Keyboard mapping.  ImGui will use those indices to peek into the io.KeyDown[] array.
     io.KeyMap[ImGuiKey_Tab] = VK_TAB;
     io.KeyMap[ImGuiKey_LeftArrow] = VK_LEFT;
@@ -70,6 +71,7 @@ void ImGuiManager::Init(int viewID)
     io.KeyMap[ImGuiKey_X] = 'X';
     io.KeyMap[ImGuiKey_Y] = 'Y';
     io.KeyMap[ImGuiKey_Z] = 'Z';
+#endif
 
     ImGui_Implbgfx_Init( viewID );
 }
@@ -139,10 +141,12 @@ void ImGuiManager::StartFrame(float deltaTime)
     io.DisplaySize.x = (float)m_pFramework->GetWindowClientWidth();
     io.DisplaySize.y = (float)m_pFramework->GetWindowClientHeight();
 
+#if FW_PLATFORM_WINDOWS
     io.KeyCtrl = io.KeysDown[VK_CONTROL] || io.KeysDown[VK_LCONTROL] || io.KeysDown[VK_RCONTROL];
     io.KeyShift = io.KeysDown[VK_SHIFT] || io.KeysDown[VK_LSHIFT] || io.KeysDown[VK_RSHIFT];
     io.KeyAlt = io.KeysDown[VK_MENU] || io.KeysDown[VK_LMENU] || io.KeysDown[VK_RMENU];
     io.KeySuper = io.KeysDown[VK_LWIN] || io.KeysDown[VK_RWIN];
+#endif
 
     int mx, my;
     m_pFramework->GetMouseCoordinates( &mx, &my );
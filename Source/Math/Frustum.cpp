@@ -0,0 +1,43 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "CoreHeaders.h"
+
+#include "Frustum.h"
+#include "Matrix.h"
+
+namespace fw {
+
+void Frustum::Set(const mat4& viewProj)
+{
+    // Planes come from adding or subtracting the rows of the matrix from its 4th row.
+    const mat4& m = viewProj;
+    m_Planes[Left]   = vec4( m.m14 + m.m11, m.m24 + m.m21, m.m34 + m.m31, m.m44 + m.m41 );
+    m_Planes[Right]  = vec4( m.m14 - m.m11, m.m24 - m.m21, m.m34 - m.m31, m.m44 - m.m41 );
+    m_Planes[Bottom] = vec4( m.m14 + m.m12, m.m24 + m.m22, m.m34 + m.m32, m.m44 + m.m42 );
+    m_Planes[Top]    = vec4( m.m14 - m.m12, m.m24 - m.m22, m.m34 - m.m32, m.m44 - m.m42 );
+    // Uses the -1 to 1 depth range, for 0 to 1 projections this near plane is a bit further back, which only culls less.
+    m_Planes[Near]   = vec4( m.m14 + m.m13, m.m24 + m.m23, m.m34 + m.m33, m.m44 + m.m43 );
+    m_Planes[Far]    = vec4( m.m14 - m.m13, m.m24 - m.m23, m.m34 - m.m33, m.m44 - m.m43 );
+
+    // Normalize so distances from the planes are in world units.
+    for( int i=0; i<NumPlanes; i++ )
+    {
+        float length = sqrtf( m_Planes[i].x * m_Planes[i].x + m_Planes[i].y * m_Planes[i].y + m_Planes[i].z * m_Planes[i].z );
+        if( length > 0 )
+        {
+            m_Planes[i].x /= length;
+            m_Planes[i].y /= length;
+            m_Planes[i].z /= length;
+            m_Planes[i].w /= length;
+        }
+    }
+}
+
+} // namespace fw
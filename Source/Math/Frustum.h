@@ -0,0 +1,58 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#pragma once
+
+#include "Vector.h"
+
+namespace fw {
+
+class mat4;
+
+// View frustum as 6 planes facing inwards, each stored as (normal, distance).
+// Built from a view projection matrix, so it's in world space.
+class Frustum
+{
+public:
+    enum Planes
+    {
+        Left,
+        Right,
+        Bottom,
+        Top,
+        Near,
+        Far,
+        NumPlanes,
+    };
+
+public:
+    Frustum() {}
+    Frustum(const mat4& viewProj) { Set( viewProj ); }
+
+    void Set(const mat4& viewProj);
+
+    bool IsSphereVisible(const vec3& center, float radius) const
+    {
+        for( int i=0; i<NumPlanes; i++ )
+        {
+            if( m_Planes[i].x * center.x + m_Planes[i].y * center.y + m_Planes[i].z * center.z + m_Planes[i].w < -radius )
+                return false;
+        }
+
+        return true;
+    }
+
+    // Getters.
+    const vec4& GetPlane(Planes plane) const { return m_Planes[plane]; }
+
+protected:
+    vec4 m_Planes[NumPlanes];
+};
+
+} // namespace fw
@@ -10,6 +10,7 @@
 #include "CoreHeaders.h"
 
 #include "Matrix.h"
+#include "Quaternion.h"
 
 namespace fw {
 
@@ -82,6 +83,11 @@ void mat4::CreateRotation(vec3 eulerdegrees)
     Rotate(eulerdegrees.y, 0, 1, 0); // yaw
 }
 
+void mat4::CreateRotation(const quat& rot)
+{
+    CreateSRT( vec3(1), rot, vec3(0) );
+}
+
 void mat4::CreateTranslation(float x, float y, float z)
 {
     m12 = m13 = m14 = m21 = m23 = m24 = m31 = m32 = m34 = 0;
@@ -119,6 +125,33 @@ void mat4::CreateSRT(vec3 scale, vec3 rot, vec3 pos)
     Translate(pos.x, pos.y, pos.z);
 }
 
+void mat4::CreateSRT(vec3 scale, const quat& rot, vec3 pos)
+{
+    float xx = rot.x * rot.x, yy = rot.y * rot.y, zz = rot.z * rot.z;
+    float xy = rot.x * rot.y, xz = rot.x * rot.z, yz = rot.y * rot.z;
+    float wx = rot.w * rot.x, wy = rot.w * rot.y, wz = rot.w * rot.z;
+
+    m11 = (1 - 2 * (yy + zz)) * scale.x;
+    m12 = 2 * (xy - wz) * scale.x;
+    m13 = 2 * (xz + wy) * scale.x;
+    m14 = 0;
+
+    m21 = 2 * (xy + wz) * scale.y;
+    m22 = (1 - 2 * (xx + zz)) * scale.y;
+    m23 = 2 * (yz - wx) * scale.y;
+    m24 = 0;
+
+    m31 = 2 * (xz - wy) * scale.z;
+    m32 = 2 * (yz + wx) * scale.z;
+    m33 = (1 - 2 * (xx + yy)) * scale.z;
+    m34 = 0;
+
+    m41 = pos.x;
+    m42 = pos.y;
+    m43 = pos.z;
+    m44 = 1;
+}
+
 void mat4::Scale(float scale)
 {
     m11 *= scale; m21 *= scale; m31 *= scale; m41 *= scale;
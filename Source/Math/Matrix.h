@@ -13,6 +13,8 @@
 
 namespace fw {
 
+class quat;
+
 // Values are stored column major.
 // m11 m21 m31 m41       Sx  0  0 Tx
 // m12 m22 m32 m42  --\   0 Sy  0 Ty
@@ -68,10 +70,13 @@ public:
     void CreateScale(float x, float y, float z);
     void CreateScale(vec3 scale);
     void CreateRotation(vec3 eulerdegrees);
+    void CreateRotation(const quat& rot);
     void CreateTranslation(float x, float y, float z);
     void CreateTranslation(vec3 pos);
     void CreateSRT(float scale, vec3 rot, vec3 pos);
     void CreateSRT(vec3 scale, vec3 rot, vec3 pos);
+    // No trig, so much cheaper than the euler versions.
+    void CreateSRT(vec3 scale, const quat& rot, vec3 pos);
     void CreateFrustum(float left, float right, float bottom, float top, float nearZ, float farZ);
     void CreatePerspectiveVFoV(float vertfovdegrees, float aspect, float nearZ, float farZ);
     void CreatePerspectiveHFoV(float horfovdegrees, float aspect, float nearZ, float farZ);
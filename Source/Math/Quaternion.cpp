@@ -0,0 +1,188 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "CoreHeaders.h"
+
+#include "Quaternion.h"
+#include "Matrix.h"
+
+#if FW_SIMD_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace fw {
+
+quat quat::CreateFromAxisAngle(vec3 axis, float degrees)
+{
+    axis.Normalize();
+
+    float halfAngle = degreesToRads( degrees ) * 0.5f;
+    float sinHalfAngle = sinf( halfAngle );
+
+    return quat( axis.x * sinHalfAngle, axis.y * sinHalfAngle, axis.z * sinHalfAngle, cosf( halfAngle ) );
+}
+
+quat quat::CreateFromEuler(vec3 eulerdegrees)
+{
+    // Same order as mat4::CreateRotation, roll then pitch then yaw.
+    quat roll = CreateFromAxisAngle( vec3(0,0,1), eulerdegrees.z );
+    quat pitch = CreateFromAxisAngle( vec3(1,0,0), eulerdegrees.x );
+    quat yaw = CreateFromAxisAngle( vec3(0,1,0), eulerdegrees.y );
+
+    return yaw * pitch * roll;
+}
+
+quat quat::CreateFromMatrix(const mat4& matrix)
+{
+    // Remove scale from each axis.
+    vec3 right = vec3( matrix.m11, matrix.m12, matrix.m13 ).GetNormalized();
+    vec3 up = vec3( matrix.m21, matrix.m22, matrix.m23 ).GetNormalized();
+    vec3 at = vec3( matrix.m31, matrix.m32, matrix.m33 ).GetNormalized();
+
+    // Inverse of the mapping in mat4::CreateRotation( quat ).
+    quat result;
+    float trace = right.x + up.y + at.z;
+    if( trace > 0 )
+    {
+        float s = sqrtf( trace + 1.0f ) * 2;
+        result.w = 0.25f * s;
+        result.x = (at.y - up.z) / s;
+        result.y = (right.z - at.x) / s;
+        result.z = (up.x - right.y) / s;
+    }
+    else if( right.x > up.y && right.x > at.z )
+    {
+        float s = sqrtf( 1.0f + right.x - up.y - at.z ) * 2;
+        result.w = (at.y - up.z) / s;
+        result.x = 0.25f * s;
+        result.y = (right.y + up.x) / s;
+        result.z = (right.z + at.x) / s;
+    }
+    else if( up.y > at.z )
+    {
+        float s = sqrtf( 1.0f + up.y - right.x - at.z ) * 2;
+        result.w = (right.z - at.x) / s;
+        result.x = (right.y + up.x) / s;
+        result.y = 0.25f * s;
+        result.z = (up.z + at.y) / s;
+    }
+    else
+    {
+        float s = sqrtf( 1.0f + at.z - right.x - up.y ) * 2;
+        result.w = (up.x - right.y) / s;
+        result.x = (right.z + at.x) / s;
+        result.y = (up.z + at.y) / s;
+        result.z = 0.25f * s;
+    }
+
+    return result.GetNormalized();
+}
+
+quat quat::Slerp(const quat& start, const quat& end, float perc)
+{
+    // Take the short way around.
+    float cosAngle = start.Dot( end );
+    float endSign = 1.0f;
+    if( cosAngle < 0 )
+    {
+        cosAngle = -cosAngle;
+        endSign = -1.0f;
+    }
+
+    // Nearly parallel, sin(angle) is too small to divide by.
+    if( cosAngle > 0.9995f )
+        return Nlerp( start, end, perc );
+
+    float angle = acosf( cosAngle );
+    float invSinAngle = 1.0f / sinf( angle );
+    float startScale = sinf( (1 - perc) * angle ) * invSinAngle;
+    float endScale = sinf( perc * angle ) * invSinAngle * endSign;
+
+#if FW_SIMD_SSE
+    __m128 result = _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( &start.x ), _mm_set1_ps( startScale ) ),
+                                _mm_mul_ps( _mm_loadu_ps( &end.x ), _mm_set1_ps( endScale ) ) );
+    quat q;
+    _mm_storeu_ps( &q.x, result );
+    return q;
+#else
+    return quat( start.x * startScale + end.x * endScale,
+                 start.y * startScale + end.y * endScale,
+                 start.z * startScale + end.z * endScale,
+                 start.w * startScale + end.w * endScale );
+#endif
+}
+
+quat quat::Nlerp(const quat& start, const quat& end, float perc)
+{
+    float endScale = start.Dot( end ) < 0 ? -perc : perc;
+    float startScale = 1 - perc;
+
+    quat result( start.x * startScale + end.x * endScale,
+                 start.y * startScale + end.y * endScale,
+                 start.z * startScale + end.z * endScale,
+                 start.w * startScale + end.w * endScale );
+
+    return result.GetNormalized();
+}
+
+vec3 quat::GetEulerAngles() const
+{
+    mat4 rotation;
+    rotation.CreateRotation( *this );
+    return rotation.GetEulerAngles();
+}
+
+// Returns o followed by this, which is the Hamilton product o*this.
+quat quat::operator *(const quat& o) const
+{
+    const quat& a = o;
+    const quat& b = *this;
+
+#if FW_SIMD_SSE
+    __m128 va = _mm_loadu_ps( &a.x );
+    __m128 vb = _mm_loadu_ps( &b.x );
+    __m128 signW = _mm_set_ps( -0.0f, 0.0f, 0.0f, 0.0f );
+
+    // x = aw*bx + ax*bw + ay*bz - az*by
+    // y = aw*by + ay*bw + az*bx - ax*bz
+    // z = aw*bz + az*bw + ax*by - ay*bx
+    // w = aw*bw - ax*bx - ay*by - az*bz
+    __m128 t0 = _mm_mul_ps( _mm_shuffle_ps( va, va, _MM_SHUFFLE(3,3,3,3) ), vb );
+    __m128 t1 = _mm_mul_ps( _mm_shuffle_ps( va, va, _MM_SHUFFLE(0,2,1,0) ), _mm_shuffle_ps( vb, vb, _MM_SHUFFLE(0,3,3,3) ) );
+    __m128 t2 = _mm_mul_ps( _mm_shuffle_ps( va, va, _MM_SHUFFLE(1,0,2,1) ), _mm_shuffle_ps( vb, vb, _MM_SHUFFLE(1,1,0,2) ) );
+    __m128 t3 = _mm_mul_ps( _mm_shuffle_ps( va, va, _MM_SHUFFLE(2,1,0,2) ), _mm_shuffle_ps( vb, vb, _MM_SHUFFLE(2,0,2,1) ) );
+
+    __m128 result = _mm_add_ps( t0, _mm_xor_ps( t1, signW ) );
+    result = _mm_add_ps( result, _mm_xor_ps( t2, signW ) );
+    result = _mm_sub_ps( result, t3 );
+
+    quat q;
+    _mm_storeu_ps( &q.x, result );
+    return q;
+#else
+    return quat( a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+                 a.w * b.y + a.y * b.w + a.z * b.x - a.x * b.z,
+                 a.w * b.z + a.z * b.w + a.x * b.y - a.y * b.x,
+                 a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z );
+#endif
+}
+
+// Same result as mat4::CreateRotation( *this ) * o.
+vec3 quat::operator *(const vec3& o) const
+{
+    float xx = x * x, yy = y * y, zz = z * z;
+    float xy = x * y, xz = x * z, yz = y * z;
+    float wx = w * x, wy = w * y, wz = w * z;
+
+    return vec3( (1 - 2 * (yy + zz)) * o.x + 2 * (xy + wz) * o.y + 2 * (xz - wy) * o.z,
+                 2 * (xy - wz) * o.x + (1 - 2 * (xx + zz)) * o.y + 2 * (yz + wx) * o.z,
+                 2 * (xz + wy) * o.x + 2 * (yz - wx) * o.y + (1 - 2 * (xx + yy)) * o.z );
+}
+
+} // namespace fw
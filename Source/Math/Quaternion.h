@@ -0,0 +1,69 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#pragma once
+
+#include "Vector.h"
+
+// Multiply and slerp use SSE when available, define FW_SIMD_SSE as 0 to force the scalar versions.
+#ifndef FW_SIMD_SSE
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FW_SIMD_SSE 1
+#else
+#define FW_SIMD_SSE 0
+#endif
+#endif
+
+namespace fw {
+
+class mat4;
+
+// Rotation quaternion, angles are in degrees to match mat4.
+// Rotations follow the same conventions as mat4::Rotate, so for any a and b:
+//    mat4::CreateRotation( a * b ) == mat4::CreateRotation( a ) * mat4::CreateRotation( b )
+//    i.e. a * b rotates by b, then by a.
+class quat
+{
+public:
+    float x, y, z, w;
+
+public:
+    quat() {}
+    quat(float nx, float ny, float nz, float nw) { x = nx; y = ny; z = nz; w = nw; }
+
+    static const quat Identity() { return quat( 0, 0, 0, 1 ); }
+    static quat CreateFromAxisAngle(vec3 axis, float degrees);
+    // Same rotation as mat4::CreateRotation( eulerdegrees ).
+    static quat CreateFromEuler(vec3 eulerdegrees);
+    // Uses the rotation part of the matrix, scale is removed first.
+    static quat CreateFromMatrix(const mat4& matrix);
+
+    static quat Slerp(const quat& start, const quat& end, float perc);
+    static quat Nlerp(const quat& start, const quat& end, float perc);
+
+    inline float Dot(const quat& o) const { return x * o.x + y * o.y + z * o.z + w * o.w; }
+    inline float LengthSquared() const { return x * x + y * y + z * z + w * w; }
+    inline float Length() const { return sqrtf( x * x + y * y + z * z + w * w ); }
+
+    inline quat GetNormalized() const { float len = Length(); if(fequal(len, 0)) return Identity(); len = 1.0f / len; return quat(x * len, y * len, z * len, w * len); }
+    inline quat Normalize() { *this = GetNormalized(); return *this; }
+    // The inverse of a unit quaternion.
+    inline quat GetConjugate() const { return quat( -x, -y, -z, w ); }
+
+    vec3 GetEulerAngles() const;
+
+    quat operator *(const quat& o) const;
+    vec3 operator *(const vec3& o) const;
+
+    inline quat operator -() const { return quat( -x, -y, -z, -w ); }
+    inline bool operator ==(const quat& o) const { return fequal(x, o.x) && fequal(y, o.y) && fequal(z, o.z) && fequal(w, o.w); }
+    inline bool operator !=(const quat& o) const { return !(*this == o); }
+};
+
+} // namespace fw
@@ -506,6 +506,13 @@ public:
     inline bool operator ==(const color4f& o) const { return fequal(this->r, o.r) && fequal(this->g, o.g) && fequal(this->b, o.b) && fequal(this->a, o.a); }
     inline bool operator !=(const color4f& o) const { return !fequal(this->r, o.r) || !fequal(this->g, o.g) || !fequal(this->b, o.b) || !fequal(this->a, o.a); }
 
+    // Packed as 8-bit ABGR, the byte order bgfx's normalized Uint8 Color0 attribute expects. Channels are clamped to 0-1.
+    inline uint32 GetABGR() const
+    {
+        return (uint32)(MyClamp_Return( a, 0.0f, 1.0f ) * 255 + 0.5f) << 24 | (uint32)(MyClamp_Return( b, 0.0f, 1.0f ) * 255 + 0.5f) << 16 |
+               (uint32)(MyClamp_Return( g, 0.0f, 1.0f ) * 255 + 0.5f) << 8 | (uint32)(MyClamp_Return( r, 0.0f, 1.0f ) * 255 + 0.5f);
+    }
+
     // Primary.
     static const color4f Red()              { return color4f(1.0f, 0.0f, 0.0f, 1.0f); }
     static const color4f Green()            { return color4f(0.0f, 1.0f, 0.0f, 1.0f); }
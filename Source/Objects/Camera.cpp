@@ -12,6 +12,7 @@
 #include "bgfx/platform.h"
 
 #include "Camera.h"
+#include "FWCore.h"
 #include "GameCore.h"
 #include "Components/CoreComponents.h"
 #include "Scenes/Scene.h"
@@ -49,7 +50,8 @@ void Camera::Update(float32 deltaTime)
 void Camera::Enable(int viewID)
 {
     // Setup view and projection matrices and uniforms.
-    bgfx::setViewTransform( viewID, &m_ViewMatrix.m11, &m_ProjectionMatrix.m11 );
+    // With pipelined rendering, the view is set when the snapshot is submitted next frame.
+    m_pScene->GetGameCore()->GetFramework()->SetViewTransform( viewID, m_ViewMatrix, m_ProjectionMatrix );
 }
 
 } // namespace fw
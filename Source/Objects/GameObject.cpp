@@ -39,6 +39,14 @@ GameObject::GameObject(Scene* pScene, std::string name, vec3 pos, Mesh* pMesh, M
 
 GameObject::~GameObject()
 {
+    // flecs deletes children along with their parent, but their GameObjects still own them, so detach them first.
+    std::vector<flecs::entity> children;
+    m_Entity.children( [&children](flecs::entity child) { children.push_back( child ); } );
+    for( flecs::entity child : children )
+    {
+        child.remove( flecs::ChildOf, m_Entity );
+    }
+
     m_Entity.destruct();
 }
 
@@ -46,6 +54,19 @@ void GameObject::Update(float deltaTime)
 {
 }
 
+void GameObject::SetParent(GameObject* pParent)
+{
+    if( pParent )
+    {
+        assert( pParent->GetScene() == m_pScene );
+        m_Entity.child_of( pParent->GetEntity() );
+    }
+    else
+    {
+        m_Entity.remove( flecs::ChildOf, flecs::Wildcard );
+    }
+}
+
 void GameObject::SaveToJSON(nlohmann::json& jGameObject)
 {
     m_pScene->GetComponentManager()->SaveGameObjectComponentsToJSON( this, jGameObject );
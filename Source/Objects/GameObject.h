@@ -10,6 +10,7 @@
 #pragma once
 
 #include "Math/Vector.h"
+#include "Utility/ObjectPool.h"
 
 namespace fw {
 
@@ -22,18 +23,39 @@ class ShaderProgram;
 class Texture;
 class Uniforms;
 
+// Identifies a GameObject in its Scene, see Scene::GetGameObject.
+struct GameObjectHandle
+{
+    uint32 poolIndex = 0;
+    PoolHandle handle;
+
+    bool IsNull() const { return handle.IsNull(); }
+    bool operator==(const GameObjectHandle& other) const { return poolIndex == other.poolIndex && handle == other.handle; }
+    bool operator!=(const GameObjectHandle& other) const { return !(*this == other); }
+};
+
+// GameObjects are stored in pools owned by their Scene, create them with Scene::CreateGameObject.
 class GameObject
 {
+    friend class Scene;
+
 public:
     GameObject(Scene* pScene);
     GameObject(Scene* pScene, std::string name, vec3 pos, Mesh* pMesh, Material* pMaterial);
     virtual ~GameObject();
 
+    // Only called for objects the scene considers updatable, see Scene::SetUpdatable.
+    // Logic that works on components alone is better off as a flecs system, which can run multithreaded.
     virtual void Update(float deltaTime);
 
     // Getters.
     Scene* GetScene() { return m_pScene; }
     flecs::entity GetEntity() { return m_Entity; }
+    GameObjectHandle GetHandle() { return m_Handle; }
+
+    // Hierarchy, uses flecs' ChildOf. Children's TransformData is relative to the parent.
+    void SetParent(GameObject* pParent);
+    flecs::entity GetParentEntity() { return m_Entity.parent(); }
 
     // Save/Load.
     virtual void SaveToJSON(nlohmann::json& jGameObject);
@@ -43,6 +65,13 @@ protected:
     Scene* m_pScene = nullptr;
 
     flecs::entity m_Entity;
+    GameObjectHandle m_Handle;
+
+private:
+    // Positions in the Scene's object lists, so it can remove objects without searching.
+    static const uint32 c_NotListed = 0xFFFFFFFF;
+    uint32 m_SceneIndex = c_NotListed;
+    uint32 m_UpdatableIndex = c_NotListed;
 };
 
 } // namespace fw
@@ -0,0 +1,103 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "CoreHeaders.h"
+
+#include "bgfx/platform.h"
+
+#include "FWCore.h"
+#include "GameCore.h"
+#include "Renderer/FramePipeline.h"
+#include "Utility/Utility.h"
+
+#if FW_HEADLESS
+
+namespace fw {
+
+// Headless backend.
+// There's no window, no input and nothing to present to, bgfx always runs with the Noop renderer.
+// The main loop in FWCore::Run keeps going until Shutdown is called or the frame limit is reached.
+
+// Public methods
+
+FWCore::FWCore(uint32 width, uint32 height, bgfx::RendererType::Enum renderType)
+{
+    Init( width, height );
+
+    if( renderType != bgfx::RendererType::Noop )
+    {
+        OutputMessage( "Headless platform: Requested renderer ignored, using Noop.\n" );
+    }
+
+    // Initialize bgfx.
+    bgfx::Init init;
+
+    init.platformData.nwh = nullptr;
+    init.type = bgfx::RendererType::Noop;
+
+    init.resolution.width = width;
+    init.resolution.height = height;
+    m_ResetFlags = BGFX_RESET_NONE;
+    init.resolution.reset = m_ResetFlags;
+
+    bool succeeded = bgfx::init( init );
+    assert( succeeded );
+
+    // There's no focus to lose, treat the "window" as always active.
+    m_WindowIsActive = true;
+    ResizeWindow( width, height );
+}
+
+FWCore::~FWCore()
+{
+    // Stop the render thread and task threads before shutting down bgfx.
+    delete m_pFramePipeline;
+    delete m_pTaskScheduler;
+
+    bgfx::shutdown();
+}
+
+bool FWCore::Init(uint32 width, uint32 height)
+{
+    m_WindowClientWidth = width;
+    m_WindowClientHeight = height;
+
+    return true;
+}
+
+bool FWCore::ProcessPlatformMessages()
+{
+    return m_QuitRequested == false;
+}
+
+void FWCore::Shutdown()
+{
+    m_pGame->OnShutdown();
+    m_QuitRequested = true;
+}
+
+void FWCore::SetWindowPositionAndSize(int32 x, int32 y, uint32 width, uint32 height, bool maximized)
+{
+    ResizeWindow( width, height );
+}
+
+void FWCore::SetClientPositionAndSize(int32 x, int32 y, uint32 width, uint32 height, bool maximized)
+{
+    ResizeWindow( width, height );
+}
+
+void FWCore::GetMouseCoordinates(int32* mx, int32* my)
+{
+    *mx = 0;
+    *my = 0;
+}
+
+} // namespace fw
+
+#endif // FW_HEADLESS
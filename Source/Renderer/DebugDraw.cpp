@@ -0,0 +1,308 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "CoreHeaders.h"
+
+#include <mutex>
+
+#include "DebugDraw.h"
+#include "Resources/ShaderProgram.h"
+#include "Utility/Profiler.h"
+#include "Utility/Utility.h"
+
+namespace fw {
+namespace DebugDraw {
+
+bgfx::VertexLayout Vertex::s_VertexLayout;
+
+void Vertex::InitVertexLayout()
+{
+    s_VertexLayout
+        .begin()
+        .add( bgfx::Attrib::Position, 3, bgfx::AttribType::Float )
+        .add( bgfx::Attrib::Color0, 4, bgfx::AttribType::Uint8, true )
+        .end();
+}
+
+#if FW_DEBUG_DRAW_ENABLED
+
+static const uint32 c_CircleSegments = 32;
+
+struct ThreadBuffer
+{
+    // Only contended while Flush is copying out of it.
+    std::mutex mutex;
+
+    // Pairs of vertices for lines and triples for triangles.
+    // Cleared rather than freed, so after the first few frames adding shapes doesn't allocate.
+    std::vector<Vertex> lines;
+    std::vector<Vertex> triangles;
+};
+
+static std::mutex g_ThreadBuffersMutex;
+static std::vector<ThreadBuffer*> g_ThreadBuffers;
+static thread_local ThreadBuffer* t_pThreadBuffer = nullptr;
+
+static ThreadBuffer* GetThreadBuffer()
+{
+    if( t_pThreadBuffer == nullptr )
+    {
+        // Buffers are never freed, worker threads live as long as the framework does.
+        ThreadBuffer* pBuffer = new ThreadBuffer;
+
+        std::lock_guard<std::mutex> lock( g_ThreadBuffersMutex );
+        g_ThreadBuffers.push_back( pBuffer );
+
+        t_pThreadBuffer = pBuffer;
+    }
+
+    return t_pThreadBuffer;
+}
+
+// Corners are indexed with x, y and z in bits 0, 1 and 2, so edges join corners that differ by one bit.
+static void AddBoxEdges(ThreadBuffer* pBuffer, const vec3* corners, uint32 abgr)
+{
+    for( uint32 i=0; i<8; i++ )
+    {
+        for( uint32 bit=1; bit<8; bit<<=1 )
+        {
+            if( (i & bit) == 0 )
+            {
+                pBuffer->lines.push_back( { corners[i], abgr } );
+                pBuffer->lines.push_back( { corners[i | bit], abgr } );
+            }
+        }
+    }
+}
+
+void AddLine(const vec3& start, const vec3& end, const color4f& color)
+{
+    ThreadBuffer* pBuffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock( pBuffer->mutex );
+
+    uint32 abgr = color.GetABGR();
+    pBuffer->lines.push_back( { start, abgr } );
+    pBuffer->lines.push_back( { end, abgr } );
+}
+
+void AddBox(const vec3& min, const vec3& max, const color4f& color)
+{
+    vec3 corners[8];
+    for( uint32 i=0; i<8; i++ )
+    {
+        corners[i] = vec3( i & 1 ? max.x : min.x, i & 2 ? max.y : min.y, i & 4 ? max.z : min.z );
+    }
+
+    ThreadBuffer* pBuffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock( pBuffer->mutex );
+    AddBoxEdges( pBuffer, corners, color.GetABGR() );
+}
+
+void AddBox(const mat4& worldMatrix, const color4f& color)
+{
+    vec3 corners[8];
+    for( uint32 i=0; i<8; i++ )
+    {
+        corners[i] = worldMatrix * vec3( i & 1 ? 0.5f : -0.5f, i & 2 ? 0.5f : -0.5f, i & 4 ? 0.5f : -0.5f );
+    }
+
+    ThreadBuffer* pBuffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock( pBuffer->mutex );
+    AddBoxEdges( pBuffer, corners, color.GetABGR() );
+}
+
+void AddCircle(const vec3& center, const vec3& normal, float radius, const color4f& color)
+{
+    // Build 2 axes perpendicular to the normal, crossing with whichever world axis is furthest from it.
+    vec3 n = normal.GetNormalized();
+    vec3 other = fabsf( n.x ) < 0.9f ? vec3( 1, 0, 0 ) : vec3( 0, 1, 0 );
+    vec3 axisU = n.Cross( other ).GetNormalized() * radius;
+    vec3 axisV = n.Cross( axisU );
+
+    ThreadBuffer* pBuffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock( pBuffer->mutex );
+
+    uint32 abgr = color.GetABGR();
+    vec3 last = center + axisU;
+    for( uint32 i=1; i<=c_CircleSegments; i++ )
+    {
+        float angle = 2 * PI * i / c_CircleSegments;
+        vec3 next = center + axisU * cosf( angle ) + axisV * sinf( angle );
+        pBuffer->lines.push_back( { last, abgr } );
+        pBuffer->lines.push_back( { next, abgr } );
+        last = next;
+    }
+}
+
+void AddSphere(const vec3& center, float radius, const color4f& color)
+{
+    AddCircle( center, vec3( 1, 0, 0 ), radius, color );
+    AddCircle( center, vec3( 0, 1, 0 ), radius, color );
+    AddCircle( center, vec3( 0, 0, 1 ), radius, color );
+}
+
+void AddFrustum(const mat4& viewProj, const color4f& color)
+{
+    // Unproject the corners of clip space, using the same -1 to 1 depth range as Frustum.
+    mat4 invViewProj = viewProj;
+    if( invViewProj.Inverse() == false )
+        return;
+
+    vec3 corners[8];
+    for( uint32 i=0; i<8; i++ )
+    {
+        vec4 clip( i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f, 1.0f );
+        vec4 world = invViewProj * clip;
+        corners[i] = vec3( world.x, world.y, world.z ) / world.w;
+    }
+
+    ThreadBuffer* pBuffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock( pBuffer->mutex );
+    AddBoxEdges( pBuffer, corners, color.GetABGR() );
+}
+
+void AddAxes(const mat4& worldMatrix, float size)
+{
+    vec3 origin( worldMatrix.m41, worldMatrix.m42, worldMatrix.m43 );
+    vec3 axisX = vec3( worldMatrix.m11, worldMatrix.m12, worldMatrix.m13 ).GetNormalized() * size;
+    vec3 axisY = vec3( worldMatrix.m21, worldMatrix.m22, worldMatrix.m23 ).GetNormalized() * size;
+    vec3 axisZ = vec3( worldMatrix.m31, worldMatrix.m32, worldMatrix.m33 ).GetNormalized() * size;
+
+    AddLine( origin, origin + axisX, color4f::Red() );
+    AddLine( origin, origin + axisY, color4f::Green() );
+    AddLine( origin, origin + axisZ, color4f::Blue() );
+}
+
+void AddTriangle(const vec3& p0, const vec3& p1, const vec3& p2, const color4f& color)
+{
+    ThreadBuffer* pBuffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock( pBuffer->mutex );
+
+    uint32 abgr = color.GetABGR();
+    pBuffer->triangles.push_back( { p0, abgr } );
+    pBuffer->triangles.push_back( { p1, abgr } );
+    pBuffer->triangles.push_back( { p2, abgr } );
+}
+
+// Returns false if nothing could be allocated, otherwise numVerts is trimmed to what fit.
+static bool AllocTransient(bgfx::TransientVertexBuffer* pTVB, uint32* pNumVerts, uint32 vertsPerPrimitive, const char* type)
+{
+    if( *pNumVerts == 0 )
+        return false;
+
+    uint32 available = bgfx::getAvailTransientVertexBuffer( *pNumVerts, Vertex::s_VertexLayout );
+    available -= available % vertsPerPrimitive;
+    if( available < *pNumVerts )
+    {
+        OutputMessage( "DebugDraw: Out of transient vertex space, only drawing %d of %d %s.\n", available / vertsPerPrimitive, *pNumVerts / vertsPerPrimitive, type );
+        *pNumVerts = available;
+        if( available == 0 )
+            return false;
+    }
+
+    bgfx::allocTransientVertexBuffer( pTVB, *pNumVerts, Vertex::s_VertexLayout );
+    return true;
+}
+
+uint32 Flush(bgfx::Encoder* pEncoder, int viewID, const ShaderProgram* pShader, bool depthTest)
+{
+    FW_PROFILE_SCOPE( "DebugDraw::Flush" );
+
+    if( Vertex::s_VertexLayout.getStride() == 0 )
+    {
+        Vertex::InitVertexLayout();
+    }
+
+    std::lock_guard<std::mutex> lock( g_ThreadBuffersMutex );
+
+    uint32 numLineVerts = 0;
+    uint32 numTriangleVerts = 0;
+    for( ThreadBuffer* pBuffer : g_ThreadBuffers )
+    {
+        std::lock_guard<std::mutex> bufferLock( pBuffer->mutex );
+        numLineVerts += (uint32)pBuffer->lines.size();
+        numTriangleVerts += (uint32)pBuffer->triangles.size();
+    }
+
+    bgfx::TransientVertexBuffer lineTVB;
+    bgfx::TransientVertexBuffer triangleTVB;
+    bool hasLines = AllocTransient( &lineTVB, &numLineVerts, 2, "lines" );
+    bool hasTriangles = AllocTransient( &triangleTVB, &numTriangleVerts, 3, "triangles" );
+
+    // Copy each thread's shapes into the transient buffers, dropping whatever didn't fit.
+    Vertex* pLineDest = hasLines ? (Vertex*)lineTVB.data : nullptr;
+    Vertex* pTriangleDest = hasTriangles ? (Vertex*)triangleTVB.data : nullptr;
+    uint32 lineSpace = hasLines ? numLineVerts : 0;
+    uint32 triangleSpace = hasTriangles ? numTriangleVerts : 0;
+    for( ThreadBuffer* pBuffer : g_ThreadBuffers )
+    {
+        std::lock_guard<std::mutex> bufferLock( pBuffer->mutex );
+
+        uint32 count = std::min( lineSpace, (uint32)pBuffer->lines.size() );
+        if( count > 0 )
+        {
+            memcpy( pLineDest, pBuffer->lines.data(), count * sizeof(Vertex) );
+            pLineDest += count;
+            lineSpace -= count;
+        }
+
+        count = std::min( triangleSpace, (uint32)pBuffer->triangles.size() );
+        if( count > 0 )
+        {
+            memcpy( pTriangleDest, pBuffer->triangles.data(), count * sizeof(Vertex) );
+            pTriangleDest += count;
+            triangleSpace -= count;
+        }
+
+        pBuffer->lines.clear();
+        pBuffer->triangles.clear();
+    }
+
+    // Blended and not written to depth, so overlapping shapes stay visible through each other.
+    uint64 state = BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A | BGFX_STATE_BLEND_ALPHA | BGFX_STATE_MSAA;
+    if( depthTest )
+    {
+        state |= BGFX_STATE_DEPTH_TEST_LESS;
+    }
+
+    uint32 numDraws = 0;
+    if( hasLines )
+    {
+        pEncoder->setVertexBuffer( 0, &lineTVB, 0, numLineVerts );
+        pEncoder->setState( state | BGFX_STATE_PT_LINES | BGFX_STATE_LINEAA );
+        pEncoder->submit( viewID, pShader->GetProgram() );
+        numDraws++;
+    }
+    if( hasTriangles )
+    {
+        pEncoder->setVertexBuffer( 0, &triangleTVB, 0, numTriangleVerts );
+        pEncoder->setState( state );
+        pEncoder->submit( viewID, pShader->GetProgram() );
+        numDraws++;
+    }
+
+    return numDraws;
+}
+
+void Clear()
+{
+    std::lock_guard<std::mutex> lock( g_ThreadBuffersMutex );
+    for( ThreadBuffer* pBuffer : g_ThreadBuffers )
+    {
+        std::lock_guard<std::mutex> bufferLock( pBuffer->mutex );
+        pBuffer->lines.clear();
+        pBuffer->triangles.clear();
+    }
+}
+
+#endif // FW_DEBUG_DRAW_ENABLED
+
+} // namespace DebugDraw
+} // namespace fw
@@ -0,0 +1,88 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#pragma once
+
+#include "bgfx/bgfx.h"
+#include "Math/Matrix.h"
+#include "Math/Vector.h"
+
+// Immediate mode debug shapes, for visualizing bounds, cameras and the like without building meshes.
+// Shapes can be added from any thread, each thread collects them in its own buffer.
+// Flush draws everything added since the last flush as batched lines and triangles through transient
+//   buffers, then empties the buffers. FWCore clears anything left over after bgfx::frame.
+//
+// The shader passed to Flush needs to take the Vertex layout below, positions are in world space.
+//
+// Define FW_DEBUG_DRAW_ENABLED as 0 to compile out all debug drawing, it's off by default in release builds.
+
+#ifndef FW_DEBUG_DRAW_ENABLED
+#if defined(NDEBUG)
+#define FW_DEBUG_DRAW_ENABLED 0
+#else
+#define FW_DEBUG_DRAW_ENABLED 1
+#endif
+#endif
+
+namespace fw {
+
+class ShaderProgram;
+
+namespace DebugDraw {
+
+struct Vertex
+{
+    vec3 pos;
+    uint32 color; // ABGR.
+
+    static void InitVertexLayout();
+    static bgfx::VertexLayout s_VertexLayout;
+};
+
+#if FW_DEBUG_DRAW_ENABLED
+
+// Lines.
+void AddLine(const vec3& start, const vec3& end, const color4f& color);
+void AddBox(const vec3& min, const vec3& max, const color4f& color);
+// A unit cube centered on the origin, placed by the world matrix.
+void AddBox(const mat4& worldMatrix, const color4f& color);
+void AddCircle(const vec3& center, const vec3& normal, float radius, const color4f& color);
+// 3 circles around the axes.
+void AddSphere(const vec3& center, float radius, const color4f& color);
+// Edges of the volume a view projection matrix sees.
+void AddFrustum(const mat4& viewProj, const color4f& color);
+// Red, green and blue lines along the matrix's x, y and z axes.
+void AddAxes(const mat4& worldMatrix, float size);
+
+// Filled.
+void AddTriangle(const vec3& p0, const vec3& p1, const vec3& p2, const color4f& color);
+
+// Must not be called while other threads are still adding shapes.
+// Returns the number of draw calls.
+uint32 Flush(bgfx::Encoder* pEncoder, int viewID, const ShaderProgram* pShader, bool depthTest = true);
+void Clear();
+
+#else
+
+inline void AddLine(const vec3& start, const vec3& end, const color4f& color) {}
+inline void AddBox(const vec3& min, const vec3& max, const color4f& color) {}
+inline void AddBox(const mat4& worldMatrix, const color4f& color) {}
+inline void AddCircle(const vec3& center, const vec3& normal, float radius, const color4f& color) {}
+inline void AddSphere(const vec3& center, float radius, const color4f& color) {}
+inline void AddFrustum(const mat4& viewProj, const color4f& color) {}
+inline void AddAxes(const mat4& worldMatrix, float size) {}
+inline void AddTriangle(const vec3& p0, const vec3& p1, const vec3& p2, const color4f& color) {}
+inline uint32 Flush(bgfx::Encoder* pEncoder, int viewID, const ShaderProgram* pShader, bool depthTest = true) { return 0; }
+inline void Clear() {}
+
+#endif // FW_DEBUG_DRAW_ENABLED
+
+} // namespace DebugDraw
+} // namespace fw
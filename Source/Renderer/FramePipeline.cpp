@@ -0,0 +1,103 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "CoreHeaders.h"
+
+#include "FramePipeline.h"
+#include "Utility/AllocationTracker.h"
+#include "Utility/Profiler.h"
+
+namespace fw {
+
+FramePipeline::FramePipeline(FrameArena* pArena)
+    : m_Snapshots{ RenderSnapshot( pArena ), RenderSnapshot( pArena ) }
+{
+    m_RenderThread = std::thread( &FramePipeline::RenderThreadMain, this );
+}
+
+FramePipeline::~FramePipeline()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_Mutex );
+        m_QuitRequested = true;
+    }
+    m_Condition.notify_all();
+
+    m_RenderThread.join();
+}
+
+void FramePipeline::BeginSubmit(const Uniforms* pUniforms)
+{
+    assert( m_SubmitInProgress == false );
+
+    // View transforms can't go through an encoder, set them here on the main thread.
+    GetReadSnapshot()->ApplyViewTransforms();
+
+    {
+        std::lock_guard<std::mutex> lock( m_Mutex );
+        m_pUniforms = pUniforms;
+        m_SubmitRequested = true;
+        m_SubmitInProgress = true;
+    }
+    m_Condition.notify_all();
+}
+
+void FramePipeline::WaitForSubmit()
+{
+    std::unique_lock<std::mutex> lock( m_Mutex );
+    m_Condition.wait( lock, [this] { return m_SubmitInProgress == false; } );
+}
+
+void FramePipeline::SwapSnapshots()
+{
+    assert( m_SubmitInProgress == false );
+
+    m_WriteIndex = 1 - m_WriteIndex;
+    GetWriteSnapshot()->Clear();
+}
+
+void FramePipeline::RenderThreadMain()
+{
+    Profiler::SetThreadName( "Render Submit" );
+    FW_ALLOC_TAG( AllocationTag::Renderer );
+
+    while( true )
+    {
+        std::unique_lock<std::mutex> lock( m_Mutex );
+        m_Condition.wait( lock, [this] { return m_SubmitRequested || m_QuitRequested; } );
+
+        if( m_QuitRequested )
+            return;
+
+        m_SubmitRequested = false;
+        lock.unlock();
+
+        // The read snapshot isn't touched by the main thread until WaitForSubmit returns.
+        const RenderSnapshot* pSnapshot = GetReadSnapshot();
+        if( pSnapshot->GetDrawItems().empty() == false || pSnapshot->GetSpriteBatches().empty() == false )
+        {
+            FW_PROFILE_SCOPE( "RenderSnapshot::Submit" );
+
+            bgfx::Encoder* pEncoder = bgfx::begin( true );
+            assert( pEncoder != nullptr ); // Ran out of encoders, see BGFX_CONFIG_MAX_ENCODERS.
+            if( pEncoder )
+            {
+                pSnapshot->Submit( pEncoder, m_pUniforms );
+                bgfx::end( pEncoder );
+            }
+        }
+
+        lock.lock();
+        m_SubmitInProgress = false;
+        lock.unlock();
+        m_Condition.notify_all();
+    }
+}
+
+} // namespace fw
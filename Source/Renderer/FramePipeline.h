@@ -0,0 +1,66 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "Renderer/RenderSnapshot.h"
+
+namespace fw {
+
+class Uniforms;
+
+// Double buffered render snapshots along with a render thread to submit them.
+// Frame N's snapshot is submitted through a bgfx encoder on the render thread
+//   while the main thread runs frame N+1's update.
+//
+// Main thread, once per frame:
+//    BeginSubmit()    - Kick off submission of last frame's snapshot.
+//    ...update...
+//    WaitForSubmit()  - Must be called before bgfx::frame().
+//    ...draw, fills GetWriteSnapshot()...
+//    bgfx::frame()
+//    SwapSnapshots()
+//    FrameArena::EndFrame()
+class FramePipeline
+{
+public:
+    FramePipeline(FrameArena* pArena);
+    virtual ~FramePipeline();
+
+    void BeginSubmit(const Uniforms* pUniforms);
+    void WaitForSubmit();
+    void SwapSnapshots();
+
+    // Getters.
+    RenderSnapshot* GetWriteSnapshot() { return &m_Snapshots[m_WriteIndex]; }
+    const RenderSnapshot* GetReadSnapshot() const { return &m_Snapshots[1 - m_WriteIndex]; }
+
+protected:
+    void RenderThreadMain();
+
+protected:
+    RenderSnapshot m_Snapshots[2];
+    int m_WriteIndex = 0;
+
+    const Uniforms* m_pUniforms = nullptr;
+
+    // Render thread.
+    std::thread m_RenderThread;
+    std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    bool m_SubmitRequested = false;
+    bool m_SubmitInProgress = false;
+    bool m_QuitRequested = false;
+};
+
+} // namespace fw
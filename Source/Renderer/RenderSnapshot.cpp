@@ -0,0 +1,86 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "CoreHeaders.h"
+
+#include "RenderSnapshot.h"
+#include "Renderer/SpriteBatch.h"
+#include "Resources/Mesh.h"
+
+namespace fw {
+
+RenderSnapshot::RenderSnapshot(FrameArena* pArena)
+    : m_pArena( pArena )
+    , m_DrawItems( FrameArenaAllocator<DrawItem>( pArena ) )
+    , m_SpriteBatches( FrameArenaAllocator<SpriteBatchItem>( pArena ) )
+    , m_ViewTransforms( FrameArenaAllocator<ViewTransform>( pArena ) )
+{
+}
+
+RenderSnapshot::~RenderSnapshot()
+{
+}
+
+void RenderSnapshot::Clear()
+{
+    // The old storage belongs to an arena buffer that's about to be reset, so start with new empty vectors.
+    m_DrawItems = FrameVector<DrawItem>( FrameArenaAllocator<DrawItem>( m_pArena ) );
+    m_SpriteBatches = FrameVector<SpriteBatchItem>( FrameArenaAllocator<SpriteBatchItem>( m_pArena ) );
+    m_ViewTransforms = FrameVector<ViewTransform>( FrameArenaAllocator<ViewTransform>( m_pArena ) );
+}
+
+void RenderSnapshot::AddDrawItem(int viewID, Mesh* pMesh, Material* pMaterial, const mat4& worldMatrix, uint32 lod, vec4 lodFade)
+{
+    m_DrawItems.push_back( { worldMatrix, lodFade, pMesh->GetDrawState( lod ), pMaterial->GetDrawState(), (uint16)viewID } );
+}
+
+void RenderSnapshot::AddSpriteBatch(int viewID, SpriteBatch* pBatch)
+{
+    m_SpriteBatches.push_back( { pBatch, (uint16)viewID } );
+}
+
+void RenderSnapshot::SetViewTransform(int viewID, const mat4& viewMatrix, const mat4& projMatrix)
+{
+    // Overwrite the existing entry if this view was already set this frame.
+    for( ViewTransform& view : m_ViewTransforms )
+    {
+        if( view.viewID == viewID )
+        {
+            view.viewMatrix = viewMatrix;
+            view.projMatrix = projMatrix;
+            return;
+        }
+    }
+
+    m_ViewTransforms.push_back( { viewMatrix, projMatrix, (uint16)viewID } );
+}
+
+void RenderSnapshot::ApplyViewTransforms() const
+{
+    for( const ViewTransform& view : m_ViewTransforms )
+    {
+        bgfx::setViewTransform( view.viewID, &view.viewMatrix.m11, &view.projMatrix.m11 );
+    }
+}
+
+void RenderSnapshot::Submit(bgfx::Encoder* pEncoder, const Uniforms* pUniforms) const
+{
+    for( const DrawItem& item : m_DrawItems )
+    {
+        Mesh::Draw( pEncoder, item.viewID, pUniforms, item.mesh, item.material, &item.worldMatrix, item.lodFade );
+    }
+
+    // The batch's transient buffer is allocated here, so it belongs to the frame this snapshot is submitted in.
+    for( const SpriteBatchItem& item : m_SpriteBatches )
+    {
+        item.pBatch->Submit( pEncoder, item.viewID, pUniforms );
+    }
+}
+
+} // namespace fw
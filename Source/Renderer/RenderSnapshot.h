@@ -0,0 +1,82 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#pragma once
+
+#include "bgfx/bgfx.h"
+#include "Math/Matrix.h"
+#include "Resources/Mesh.h"
+#include "Utility/FrameArena.h"
+
+namespace fw {
+
+class SpriteBatch;
+class Uniforms;
+
+// Everything needed to submit a frame's scene draws without touching the scene.
+// Filled by the main thread during Draw, then submitted by the render thread
+//   while the main thread updates the next frame.
+// Draw items and sprite batches copy the mesh and material state they use, so resources can be changed
+//   during Update. Their bgfx handles must stay alive though, bgfx keeps destroyed handles until the end
+//   of the frame, so a resource deleted during Update is still safe to submit.
+class RenderSnapshot
+{
+public:
+    struct DrawItem
+    {
+        mat4 worldMatrix;
+        vec4 lodFade;
+        Mesh::DrawState mesh;
+        Material::DrawState material;
+        uint16 viewID;
+    };
+
+    // Sprite batches hold their own vertices, which must stay untouched until the snapshot is submitted.
+    // The scene's batch is only rebuilt during Draw, after FramePipeline::WaitForSubmit.
+    struct SpriteBatchItem
+    {
+        SpriteBatch* pBatch;
+        uint16 viewID;
+    };
+
+    struct ViewTransform
+    {
+        mat4 viewMatrix;
+        mat4 projMatrix;
+        uint16 viewID;
+    };
+
+public:
+    RenderSnapshot(FrameArena* pArena);
+    virtual ~RenderSnapshot();
+
+    void Clear();
+
+    void AddDrawItem(int viewID, Mesh* pMesh, Material* pMaterial, const mat4& worldMatrix, uint32 lod = 0, vec4 lodFade = vec4(1,0,0,0));
+    void AddSpriteBatch(int viewID, SpriteBatch* pBatch);
+    void SetViewTransform(int viewID, const mat4& viewMatrix, const mat4& projMatrix);
+
+    // View state can only be set from the main thread, so this is called before submitting.
+    void ApplyViewTransforms() const;
+    void Submit(bgfx::Encoder* pEncoder, const Uniforms* pUniforms) const;
+
+    // Getters.
+    const FrameVector<DrawItem>& GetDrawItems() const { return m_DrawItems; }
+    const FrameVector<SpriteBatchItem>& GetSpriteBatches() const { return m_SpriteBatches; }
+    const FrameVector<ViewTransform>& GetViewTransforms() const { return m_ViewTransforms; }
+
+protected:
+    // Allocated from the frame arena, so a snapshot must be cleared every frame.
+    FrameArena* m_pArena;
+    FrameVector<DrawItem> m_DrawItems;
+    FrameVector<SpriteBatchItem> m_SpriteBatches;
+    FrameVector<ViewTransform> m_ViewTransforms;
+};
+
+} // namespace fw
@@ -0,0 +1,183 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "CoreHeaders.h"
+
+#include "SpriteBatch.h"
+#include "Resources/Material.h"
+#include "Utility/Profiler.h"
+#include "Utility/Utility.h"
+
+namespace fw {
+
+bgfx::VertexLayout SpriteBatch::Vertex::s_VertexLayout;
+
+void SpriteBatch::Vertex::InitVertexLayout()
+{
+    s_VertexLayout
+        .begin()
+        .add( bgfx::Attrib::Position, 3, bgfx::AttribType::Float )
+        .add( bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Float )
+        .add( bgfx::Attrib::Color0, 4, bgfx::AttribType::Uint8, true )
+        .end();
+}
+
+SpriteBatch::SpriteBatch()
+{
+    if( Vertex::s_VertexLayout.getStride() == 0 )
+    {
+        Vertex::InitVertexLayout();
+    }
+
+    uint16* pIndices = new uint16[c_MaxSpritesPerDraw * 6];
+    for( uint32 i=0; i<c_MaxSpritesPerDraw; i++ )
+    {
+        uint16 first = (uint16)(i * 4);
+        pIndices[i*6 + 0] = first + 0;
+        pIndices[i*6 + 1] = first + 1;
+        pIndices[i*6 + 2] = first + 2;
+        pIndices[i*6 + 3] = first + 0;
+        pIndices[i*6 + 4] = first + 2;
+        pIndices[i*6 + 5] = first + 3;
+    }
+    m_QuadIndices = bgfx::createIndexBuffer( bgfx::copy( pIndices, c_MaxSpritesPerDraw * 6 * sizeof(uint16) ) );
+    delete[] pIndices;
+}
+
+SpriteBatch::~SpriteBatch()
+{
+    bgfx::destroy( m_QuadIndices );
+}
+
+void SpriteBatch::Begin()
+{
+    m_Sprites.clear();
+    m_Batches.clear();
+    m_LastBatchIndex = 0;
+    m_Uploaded = false;
+    m_NumUploadedSprites = 0;
+}
+
+void SpriteBatch::AddSprite(Material* pMaterial, const mat4& worldMatrix, vec2 uvScale, vec2 uvOffset, color4f color)
+{
+    // Sprites tend to come in runs of the same material, so check the last batch before searching.
+    if( m_Batches.empty() || m_Batches[m_LastBatchIndex].pMaterial != pMaterial )
+    {
+        m_LastBatchIndex = (uint32)m_Batches.size();
+        for( uint32 i=0; i<m_Batches.size(); i++ )
+        {
+            if( m_Batches[i].pMaterial == pMaterial )
+            {
+                m_LastBatchIndex = i;
+                break;
+            }
+        }
+
+        if( m_LastBatchIndex == m_Batches.size() )
+        {
+            m_Batches.push_back( { pMaterial, 0, 0, {} } );
+        }
+    }
+    m_Batches[m_LastBatchIndex].numSprites++;
+
+    uint32 abgr = color.GetABGR();
+
+    Sprite& sprite = m_Sprites.emplace_back();
+    sprite.batchIndex = m_LastBatchIndex;
+
+    static const vec3 c_Corners[4] = { vec3(-0.5f,-0.5f,0), vec3(-0.5f,0.5f,0), vec3(0.5f,0.5f,0), vec3(0.5f,-0.5f,0) };
+    static const vec2 c_CornerUVs[4] = { vec2(0,0), vec2(0,1), vec2(1,1), vec2(1,0) };
+    for( int i=0; i<4; i++ )
+    {
+        sprite.verts[i].pos = worldMatrix * c_Corners[i];
+        sprite.verts[i].uv = c_CornerUVs[i] * uvScale + uvOffset;
+        sprite.verts[i].color = abgr;
+    }
+}
+
+void SpriteBatch::End()
+{
+    FW_PROFILE_SCOPE( "SpriteBatch::End" );
+
+    // Counting sort into batch order, so each batch's vertices are contiguous.
+    uint32 firstSprite = 0;
+    for( Batch& batch : m_Batches )
+    {
+        batch.firstSprite = firstSprite;
+        firstSprite += batch.numSprites;
+        batch.materialState = batch.pMaterial->GetDrawState();
+    }
+
+    m_NumWritten.assign( m_Batches.size(), 0 );
+    m_Vertices.resize( m_Sprites.size() * 4 );
+    for( const Sprite& sprite : m_Sprites )
+    {
+        uint32 index = m_Batches[sprite.batchIndex].firstSprite + m_NumWritten[sprite.batchIndex]++;
+        memcpy( &m_Vertices[index * 4], sprite.verts, sizeof(sprite.verts) );
+    }
+}
+
+bool SpriteBatch::Upload()
+{
+    m_Uploaded = true;
+    m_NumUploadedSprites = 0;
+
+    uint32 numSprites = (uint32)m_Sprites.size();
+    if( numSprites == 0 )
+        return false;
+
+    uint32 numVerts = bgfx::getAvailTransientVertexBuffer( numSprites * 4, Vertex::s_VertexLayout );
+    if( numVerts < numSprites * 4 )
+    {
+        OutputMessage( "SpriteBatch: Out of transient vertex space, only drawing %d of %d sprites.\n", numVerts / 4, numSprites );
+        numSprites = numVerts / 4;
+        if( numSprites == 0 )
+            return false;
+    }
+
+    bgfx::allocTransientVertexBuffer( &m_TransientVB, numSprites * 4, Vertex::s_VertexLayout );
+    memcpy( m_TransientVB.data, m_Vertices.data(), numSprites * 4 * sizeof(Vertex) );
+    m_NumUploadedSprites = numSprites;
+
+    return true;
+}
+
+uint32 SpriteBatch::Submit(bgfx::Encoder* pEncoder, int viewID, const Uniforms* pUniforms)
+{
+    FW_PROFILE_SCOPE( "SpriteBatch::Submit" );
+
+    if( m_Uploaded == false )
+    {
+        Upload();
+    }
+
+    uint32 numDraws = 0;
+    for( const Batch& batch : m_Batches )
+    {
+        uint32 endSprite = std::min( batch.firstSprite + batch.numSprites, m_NumUploadedSprites );
+        for( uint32 first=batch.firstSprite; first<endSprite; first+=c_MaxSpritesPerDraw )
+        {
+            uint32 count = std::min( endSprite - first, c_MaxSpritesPerDraw );
+
+            pEncoder->setVertexBuffer( 0, &m_TransientVB, first * 4, count * 4 );
+            pEncoder->setIndexBuffer( m_QuadIndices, 0, count * 6 );
+
+            Material::Enable( pEncoder, pUniforms, batch.materialState );
+            pEncoder->setState( batch.materialState.renderState | BGFX_STATE_MSAA );
+
+            // Vertices are already in world space, so the default identity transform is used.
+            pEncoder->submit( viewID, batch.materialState.program );
+            numDraws++;
+        }
+    }
+
+    return numDraws;
+}
+
+} // namespace fw
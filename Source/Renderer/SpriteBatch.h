@@ -0,0 +1,99 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#pragma once
+
+#include "bgfx/bgfx.h"
+#include "Math/Matrix.h"
+#include "Math/Vector.h"
+#include "Resources/Material.h"
+
+namespace fw {
+
+class Uniforms;
+
+// Collects sprites as world space quads and draws them with one draw call per material.
+// Quads are unit squares centered on the origin before the world matrix is applied, so a sprite's size comes from its scale.
+// UVs are baked into the vertices, so the materials used should keep the default UV scale and offset,
+//   and their shaders need to take the Vertex layout below.
+//
+// Sprites are grouped by material, keeping the order they were added within each material.
+// Different materials don't draw in the order they were added, so use depth to layer them.
+//
+// Once per frame:
+//    Begin()
+//    AddSprite() * N
+//    End()
+// then Submit() once per view, uploads happen on the first Submit after End.
+class SpriteBatch
+{
+public:
+    struct Vertex
+    {
+        vec3 pos;
+        vec2 uv;
+        uint32 color; // ABGR.
+
+        static void InitVertexLayout();
+        static bgfx::VertexLayout s_VertexLayout;
+    };
+
+    // Vertices in a single draw are limited by the 16 bit index buffer.
+    static const uint32 c_MaxSpritesPerDraw = 65536 / 4;
+
+public:
+    SpriteBatch();
+    virtual ~SpriteBatch();
+
+    void Begin();
+    void AddSprite(Material* pMaterial, const mat4& worldMatrix, vec2 uvScale, vec2 uvOffset, color4f color);
+    void End();
+
+    // Copies the vertices into a transient buffer the first time it's called after End, so it must
+    //   run before bgfx::frame and only from one thread at a time. Returns the number of draw calls.
+    uint32 Submit(bgfx::Encoder* pEncoder, int viewID, const Uniforms* pUniforms);
+
+    // Getters.
+    uint32 GetNumSprites() { return (uint32)m_Sprites.size(); }
+    uint32 GetNumBatches() { return (uint32)m_Batches.size(); }
+
+protected:
+    struct Sprite
+    {
+        Vertex verts[4];
+        uint32 batchIndex;
+    };
+
+    struct Batch
+    {
+        Material* pMaterial;
+        uint32 firstSprite;
+        uint32 numSprites;
+        // Copied by End, so Submit doesn't read the material if it changes before a snapshot is submitted.
+        Material::DrawState materialState;
+    };
+
+    bool Upload();
+
+protected:
+    std::vector<Sprite> m_Sprites;
+    std::vector<Batch> m_Batches;
+    std::vector<Vertex> m_Vertices; // Sorted into batch order by End.
+    std::vector<uint32> m_NumWritten;
+    uint32 m_LastBatchIndex = 0;
+
+    // Same 2 triangles per quad for every batch.
+    bgfx::IndexBufferHandle m_QuadIndices = BGFX_INVALID_HANDLE;
+
+    bool m_Uploaded = false;
+    uint32 m_NumUploadedSprites = 0;
+    bgfx::TransientVertexBuffer m_TransientVB;
+};
+
+} // namespace fw
@@ -0,0 +1,127 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#include "CoreHeaders.h"
+
+#include "TransientMeshBuilder.h"
+#include "FWCore.h"
+#include "Renderer/Uniforms.h"
+#include "Resources/Material.h"
+#include "Resources/ShaderProgram.h"
+#include "Utility/Utility.h"
+
+namespace fw {
+
+bool TransientMeshBuilder::Begin(const bgfx::VertexLayout& vertexFormat, uint32 maxVerts, uint32 maxIndices)
+{
+    m_Active = false;
+    m_VertexStride = vertexFormat.getStride();
+    m_MaxVerts = maxVerts;
+    m_MaxIndices = maxIndices;
+    m_NumVerts = 0;
+    m_NumIndices = 0;
+    m_BeginFrame = m_pFramework->GetFrameCount();
+
+    bool indices32 = maxVerts > 0x10000;
+    if( bgfx::getAvailTransientVertexBuffer( maxVerts, vertexFormat ) < maxVerts ||
+        bgfx::getAvailTransientIndexBuffer( maxIndices, indices32 ) < maxIndices )
+    {
+        OutputMessage( "TransientMeshBuilder: Out of transient buffer space for %d verts and %d indices.\n", maxVerts, maxIndices );
+        return false;
+    }
+
+    bgfx::allocTransientVertexBuffer( &m_TransientVB, maxVerts, vertexFormat );
+    bgfx::allocTransientIndexBuffer( &m_TransientIB, maxIndices, indices32 );
+    m_Active = true;
+
+    return true;
+}
+
+uint32 TransientMeshBuilder::AddVertices(const void* verts, uint32 numVerts)
+{
+    uint32 firstIndex;
+    void* pDest = AllocVertices( numVerts, &firstIndex );
+    memcpy( pDest, verts, numVerts * m_VertexStride );
+    return firstIndex;
+}
+
+void* TransientMeshBuilder::AllocVertices(uint32 numVerts, uint32* pFirstIndex)
+{
+    assert( m_Active && IsCurrentFrame() );
+    assert( m_NumVerts + numVerts <= m_MaxVerts );
+
+    *pFirstIndex = m_NumVerts;
+    void* pDest = m_TransientVB.data + m_NumVerts * m_VertexStride;
+    m_NumVerts += numVerts;
+    return pDest;
+}
+
+void TransientMeshBuilder::AddTriangle(uint32 i0, uint32 i1, uint32 i2)
+{
+    uint32 indices[3] = { i0, i1, i2 };
+    AddIndices( indices, 3 );
+}
+
+void TransientMeshBuilder::AddIndices(const uint32* indices, uint32 numIndices)
+{
+    assert( m_Active && IsCurrentFrame() );
+    assert( m_NumIndices + numIndices <= m_MaxIndices );
+
+    if( m_TransientIB.isIndex16 )
+    {
+        uint16* pDest = (uint16*)m_TransientIB.data + m_NumIndices;
+        for( uint32 i=0; i<numIndices; i++ )
+        {
+            assert( indices[i] < m_MaxVerts );
+            pDest[i] = (uint16)indices[i];
+        }
+    }
+    else
+    {
+        memcpy( (uint32*)m_TransientIB.data + m_NumIndices, indices, numIndices * sizeof(uint32) );
+    }
+    m_NumIndices += numIndices;
+}
+
+void TransientMeshBuilder::Draw(bgfx::Encoder* pEncoder, int viewID, const Uniforms* pUniforms, const Material* pMaterial, const mat4* worldMat)
+{
+    // The transient buffers were released by the bgfx::frame that ended Begin's frame.
+    if( m_Active && IsCurrentFrame() == false )
+    {
+        m_Active = false;
+    }
+
+    if( m_Active == false || m_NumIndices == 0 )
+        return;
+
+    // Only the part that was filled in is drawn, the rest of the allocation goes unused.
+    pEncoder->setVertexBuffer( 0, &m_TransientVB, 0, m_NumVerts );
+    pEncoder->setIndexBuffer( &m_TransientIB, 0, m_NumIndices );
+
+    pMaterial->Enable( pEncoder, pUniforms );
+    vec4 lodFade( 1, 0, 0, 0 );
+    pEncoder->setUniform( pUniforms->m_Map.at( "u_LODFade" ), &lodFade.x );
+
+    pEncoder->setState( pMaterial->GetBGFXRenderState() | BGFX_STATE_MSAA );
+
+    if( worldMat )
+    {
+        pEncoder->setTransform( &worldMat->m11 );
+    }
+
+    pEncoder->submit( viewID, pMaterial->GetShader()->GetProgram() );
+}
+
+bool TransientMeshBuilder::IsCurrentFrame()
+{
+    return m_BeginFrame == m_pFramework->GetFrameCount();
+}
+
+} // namespace fw
@@ -0,0 +1,75 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#pragma once
+
+#include "bgfx/bgfx.h"
+#include "Math/Matrix.h"
+
+namespace fw {
+
+class FWCore;
+class Material;
+class Uniforms;
+
+// Builds geometry straight into bgfx's transient buffers, for meshes that change every frame.
+// There are no handles to create or destroy and nothing is allocated, but the buffers only last until
+//   the next bgfx::frame, so the geometry has to be rebuilt and drawn each frame and can't go through
+//   a RenderSnapshot. Use a dynamic Mesh for geometry that needs to survive longer.
+//
+// Once per frame:
+//    Begin()
+//    AddVertex()/AddTriangle() * N
+//    Draw() once per view
+// Begin fails if there isn't enough transient space left this frame, in which case skip the geometry.
+// Once the frame Begin was called in has ended, Draw does nothing until Begin is called again.
+class TransientMeshBuilder
+{
+public:
+    TransientMeshBuilder(FWCore* pFramework) : m_pFramework( pFramework ) {}
+    virtual ~TransientMeshBuilder() {}
+
+    // Indices are 32-bit if maxVerts doesn't fit in 16.
+    bool Begin(const bgfx::VertexLayout& vertexFormat, uint32 maxVerts, uint32 maxIndices);
+
+    // Returns the index of the vertex added.
+    template<typename T> uint32 AddVertex(const T& vertex) { return AddVertices( &vertex, 1 ); }
+    uint32 AddVertices(const void* verts, uint32 numVerts);
+    // Returns a pointer to write numVerts vertices into, the index of the first is returned in pFirstIndex.
+    void* AllocVertices(uint32 numVerts, uint32* pFirstIndex);
+
+    void AddTriangle(uint32 i0, uint32 i1, uint32 i2);
+    void AddIndices(const uint32* indices, uint32 numIndices);
+
+    void Draw(bgfx::Encoder* pEncoder, int viewID, const Uniforms* pUniforms, const Material* pMaterial, const mat4* worldMat);
+
+    // Getters.
+    bool IsActive() { return m_Active && IsCurrentFrame(); }
+    uint32 GetNumVerts() { return m_NumVerts; }
+    uint32 GetNumIndices() { return m_NumIndices; }
+
+protected:
+    bool IsCurrentFrame();
+
+protected:
+    FWCore* m_pFramework = nullptr;
+    uint32 m_BeginFrame = 0;
+
+    bgfx::TransientVertexBuffer m_TransientVB;
+    bgfx::TransientIndexBuffer m_TransientIB;
+    uint32 m_VertexStride = 0;
+    uint32 m_MaxVerts = 0;
+    uint32 m_MaxIndices = 0;
+    uint32 m_NumVerts = 0;
+    uint32 m_NumIndices = 0;
+    bool m_Active = false;
+};
+
+} // namespace fw
@@ -36,6 +36,7 @@ void Uniforms::CreateFrameworkUniforms()
     m_Map["u_UVScaleOffset"] = bgfx::createUniform( "u_UVScaleOffset", bgfx::UniformType::Vec4 );
     m_Map["u_DiffuseColor"] = bgfx::createUniform( "u_DiffuseColor", bgfx::UniformType::Vec4 );
     m_Map["u_ControlPerc"] = bgfx::createUniform( "u_ControlPerc", bgfx::UniformType::Vec4 );
+    m_Map["u_LODFade"] = bgfx::createUniform( "u_LODFade", bgfx::UniformType::Vec4 );
 }
 
 } // namespace fw
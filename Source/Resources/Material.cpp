@@ -13,6 +13,7 @@
 
 #include "Material.h"
 #include "Renderer/Uniforms.h"
+#include "Resources/ShaderProgram.h"
 #include "Resources/Texture.h"
 
 namespace fw {
@@ -40,25 +41,56 @@ Material::~Material()
 }
 
 void Material::Enable(const Uniforms* pUniforms) const
+{
+    bgfx::Encoder* pEncoder = bgfx::begin();
+    Enable( pEncoder, pUniforms );
+    bgfx::end( pEncoder );
+}
+
+void Material::Enable(bgfx::Encoder* pEncoder, const Uniforms* pUniforms) const
+{
+    Enable( pEncoder, pUniforms, GetDrawState() );
+}
+
+void Material::Enable(bgfx::Encoder* pEncoder, const Uniforms* pUniforms, const DrawState& state)
 {
     // Textures.
-    if( m_pTextureColor )
+    if( bgfx::isValid( state.textureColor ) )
     {
-        bgfx::setTexture( 0, pUniforms->m_Map.at("u_TextureColor"), m_pTextureColor->GetHandle() );
+        pEncoder->setTexture( 0, pUniforms->m_Map.at("u_TextureColor"), state.textureColor );
     }
 
-    if( m_pTextureNoise )
+    if( bgfx::isValid( state.textureNoise ) )
     {
-        bgfx::setTexture( 1, pUniforms->m_Map.at("u_TextureNoise"), m_pTextureNoise->GetHandle() );
+        pEncoder->setTexture( 1, pUniforms->m_Map.at("u_TextureNoise"), state.textureNoise );
     }
 
     // UV scale and offset.
-    bgfx::setUniform( pUniforms->m_Map.at( "u_UVScaleOffset" ), &m_UVScaleOffset.x );
+    pEncoder->setUniform( pUniforms->m_Map.at( "u_UVScaleOffset" ), &state.uvScaleOffset.x );
 
     // Vertex Colors.
-    bgfx::setUniform( pUniforms->m_Map.at( "u_DiffuseColor" ), &m_Color.r );
+    pEncoder->setUniform( pUniforms->m_Map.at( "u_DiffuseColor" ), &state.color.r );
+
+    pEncoder->setUniform( pUniforms->m_Map.at( "u_ControlPerc" ), &state.controlPerc.x );
+}
 
-    bgfx::setUniform( pUniforms->m_Map.at( "u_ControlPerc" ), &m_ControlPerc.x );
+Material::DrawState Material::GetDrawState() const
+{
+    DrawState state;
+    state.program = BGFX_INVALID_HANDLE;
+    state.textureColor = BGFX_INVALID_HANDLE;
+    state.textureNoise = BGFX_INVALID_HANDLE;
+    if( m_pShader )
+        state.program = m_pShader->GetProgram();
+    if( m_pTextureColor )
+        state.textureColor = m_pTextureColor->GetHandle();
+    if( m_pTextureNoise )
+        state.textureNoise = m_pTextureNoise->GetHandle();
+    state.renderState = GetBGFXRenderState();
+    state.uvScaleOffset = m_UVScaleOffset;
+    state.color = m_Color;
+    state.controlPerc = m_ControlPerc;
+    return state;
 }
 
 uint64_t c_BlendEquationConversions[6] =
@@ -73,12 +73,29 @@ public:
         Always,
     };
 
+    // Everything a draw reads from the material.
+    // RenderSnapshot keeps a copy, so the material can change or be deleted before the snapshot is submitted.
+    struct DrawState
+    {
+        bgfx::ProgramHandle program;
+        bgfx::TextureHandle textureColor;
+        bgfx::TextureHandle textureNoise;
+        uint64_t renderState;
+        vec4 uvScaleOffset;
+        color4f color;
+        vec4 controlPerc;
+    };
+
 public:
     Material(const char* name, ShaderProgram* pShader, Texture* pTextureColor, color4f color, bool hasAlpha);
     Material(const char* name, ShaderProgram* pShader, Texture* pTextureColor, color4f color, bool hasAlpha, vec4 uvScaleOffset);
     virtual ~Material();
 
     void Enable(const Uniforms* pUniforms) const;
+    void Enable(bgfx::Encoder* pEncoder, const Uniforms* pUniforms) const;
+    // Sets the textures and uniforms from a copied state, the render state and program are left to the caller.
+    static void Enable(bgfx::Encoder* pEncoder, const Uniforms* pUniforms, const DrawState& state);
+    DrawState GetDrawState() const;
 
     // Getters.
     ShaderProgram* GetShader() const { return m_pShader; }
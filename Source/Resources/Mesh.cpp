@@ -15,49 +15,413 @@
 #include "Mesh.h"
 #include "ShaderProgram.h"
 #include "Math/Matrix.h"
+#include "Renderer/Uniforms.h"
 #include "Resources/Material.h"
+#include "Resources/MeshFormat.h"
+#include "Utility/FrameArena.h"
+#include "Utility/MappedFile.h"
 #include "Utility/Utility.h"
 
 namespace fw {
 
-Mesh::Mesh(const char* name, const bgfx::VertexLayout& vertexFormat, const void* verts, uint32 vertsSize, const void* indices, uint32 indicesSize)
+uint32 Mesh::s_DynamicBufferIndex = 0;
+std::vector<Mesh*> Mesh::s_DynamicMeshes;
+
+Mesh::Mesh(const char* name, const bgfx::VertexLayout& vertexFormat, const void* verts, uint32 vertsSize, const void* indices, uint32 indicesSize, bool indices32)
+    : Resource( name )
+{
+    Create( vertexFormat, verts, vertsSize, indices, indicesSize, indices32 );
+}
+
+Mesh::Mesh(const char* name, const char* filename)
+    : Resource( name )
+{
+    bool loaded = LoadFromFile( filename );
+    assert( loaded ); // Missing or corrupt mesh file.
+}
+
+Mesh::Mesh(const char* name, const bgfx::VertexLayout& vertexFormat, uint32 maxVerts, uint32 maxIndices, bool indices32)
     : Resource( name )
 {
-    Create( vertexFormat, verts, vertsSize, indices, indicesSize );
+    CreateDynamic( vertexFormat, maxVerts, maxIndices, indices32 );
 }
 
 Mesh::~Mesh()
 {
-    bgfx::destroy( m_VBO );
-    bgfx::destroy( m_IBO );
+    Destroy();
+}
+
+void Mesh::Destroy()
+{
+    if( bgfx::isValid( m_VBO ) )
+        bgfx::destroy( m_VBO );
+    if( bgfx::isValid( m_IBO ) )
+        bgfx::destroy( m_IBO );
+    for( int i=0; i<2; i++ )
+    {
+        if( bgfx::isValid( m_DynamicVBO[i] ) )
+            bgfx::destroy( m_DynamicVBO[i] );
+        if( bgfx::isValid( m_DynamicIBO[i] ) )
+            bgfx::destroy( m_DynamicIBO[i] );
+        m_DynamicVBO[i] = BGFX_INVALID_HANDLE;
+        m_DynamicIBO[i] = BGFX_INVALID_HANDLE;
+    }
+
+    if( m_Dynamic )
+    {
+        s_DynamicMeshes.erase( std::find( s_DynamicMeshes.begin(), s_DynamicMeshes.end(), this ) );
+    }
+
+    m_VBO = BGFX_INVALID_HANDLE;
+    m_IBO = BGFX_INVALID_HANDLE;
+    m_Dynamic = false;
+    m_VertexData.clear();
+    m_IndexData.clear();
+    m_PendingVertsStart = m_PendingVertsEnd = 0;
+    m_PendingIndicesStart = m_PendingIndicesEnd = 0;
+
+    // Leave an empty mesh that's still safe to draw and pick LODs for, in case loading fails.
+    m_NumVerts = 0;
+    m_NumIndices = 0;
+    m_SubMeshes.assign( 1, { 0, 0 } );
+    m_LODs.assign( 1, { 0, 0, 0.0f } );
+    m_BoundsCenter.Set( 0, 0, 0 );
+    m_BoundsRadius = -1;
+}
+
+void Mesh::Create(const bgfx::VertexLayout& vertexFormat, const void* verts, uint32 vertsSize, const void* indices, uint32 indicesSize, bool indices32)
+{
+    Destroy();
+
+    // bgfx reads the data a frame or two later, copy it so the caller doesn't need to keep it around.
+    m_VBO = bgfx::createVertexBuffer( bgfx::copy( verts, vertsSize ), vertexFormat );
+    m_IBO = bgfx::createIndexBuffer( bgfx::copy( indices, indicesSize ), indices32 ? BGFX_BUFFER_INDEX32 : BGFX_BUFFER_NONE );
+
+    m_NumVerts = vertsSize / vertexFormat.getStride();
+    m_NumIndices = indicesSize / (indices32 ? sizeof(uint32) : sizeof(uint16));
+    m_Indices32 = indices32;
+    m_SubMeshes[0] = { 0, m_NumIndices };
+    m_LODs[0] = { 0, m_NumIndices, 0.0f };
+
+    CalculateBounds( vertexFormat, verts, vertsSize, &m_BoundsCenter, &m_BoundsRadius );
+}
+
+void Mesh::CreateDynamic(const bgfx::VertexLayout& vertexFormat, uint32 maxVerts, uint32 maxIndices, bool indices32)
+{
+    // Recreating the buffers could pull them out from under a RenderSnapshot that's still being submitted.
+    assert( m_Dynamic == false );
+    Destroy();
+
+    uint16 indexFlags = indices32 ? BGFX_BUFFER_INDEX32 : BGFX_BUFFER_NONE;
+    for( int i=0; i<2; i++ )
+    {
+        m_DynamicVBO[i] = bgfx::createDynamicVertexBuffer( maxVerts, vertexFormat, BGFX_BUFFER_ALLOW_RESIZE );
+        m_DynamicIBO[i] = bgfx::createDynamicIndexBuffer( maxIndices, BGFX_BUFFER_ALLOW_RESIZE | indexFlags );
+    }
+
+    s_DynamicMeshes.push_back( this );
+    m_Dynamic = true;
+    m_VertexStride = vertexFormat.getStride();
+    m_Indices32 = indices32;
+}
+
+const bgfx::Memory* Mesh::MakeUploadMemory(const void* pData, uint32 size, FrameArena* pArena)
+{
+    if( pArena == nullptr )
+        return bgfx::copy( pData, size );
+
+    // The arena keeps a frame's allocations through the following frame, which covers bgfx's 2 frame makeRef rule.
+    void* pCopy = pArena->Allocate( size, 16 );
+    memcpy( pCopy, pData, size );
+    return bgfx::makeRef( pCopy, size );
+}
+
+void Mesh::UpdateVertices(uint32 startVertex, const void* verts, uint32 numVerts, FrameArena* pArena)
+{
+    assert( m_Dynamic );
+    if( numVerts == 0 )
+        return;
+
+    uint32 endVertex = startVertex + numVerts;
+    if( m_VertexData.size() < endVertex * m_VertexStride )
+        m_VertexData.resize( endVertex * m_VertexStride );
+    memcpy( &m_VertexData[startVertex * m_VertexStride], verts, numVerts * m_VertexStride );
+
+    // The other pair catches up in SwapDynamicBuffers, once the snapshot drawing from it is done.
+    m_PendingVertsStart = m_PendingVertsEnd > m_PendingVertsStart ? std::min( m_PendingVertsStart, startVertex ) : startVertex;
+    m_PendingVertsEnd = std::max( m_PendingVertsEnd, endVertex );
+
+    bgfx::update( m_DynamicVBO[s_DynamicBufferIndex], startVertex, MakeUploadMemory( verts, numVerts * m_VertexStride, pArena ) );
+    m_NumVerts = std::max( m_NumVerts, endVertex );
+}
+
+void Mesh::UpdateIndices(uint32 startIndex, const void* indices, uint32 numIndices, FrameArena* pArena)
+{
+    assert( m_Dynamic );
+    if( numIndices == 0 )
+        return;
+
+    uint32 indexSize = m_Indices32 ? sizeof(uint32) : sizeof(uint16);
+    uint32 endIndex = startIndex + numIndices;
+    if( m_IndexData.size() < endIndex * indexSize )
+        m_IndexData.resize( endIndex * indexSize );
+    memcpy( &m_IndexData[startIndex * indexSize], indices, numIndices * indexSize );
+
+    m_PendingIndicesStart = m_PendingIndicesEnd > m_PendingIndicesStart ? std::min( m_PendingIndicesStart, startIndex ) : startIndex;
+    m_PendingIndicesEnd = std::max( m_PendingIndicesEnd, endIndex );
+
+    bgfx::update( m_DynamicIBO[s_DynamicBufferIndex], startIndex, MakeUploadMemory( indices, numIndices * indexSize, pArena ) );
+    m_NumIndices = std::max( m_NumIndices, endIndex );
+}
+
+void Mesh::SwapDynamicBuffers(FrameArena* pArena)
+{
+    // The snapshot recorded last frame draws from the pair that was just written, so switch to the other one,
+    //   which the snapshot before it was drawing from, and fill in what it missed.
+    s_DynamicBufferIndex ^= 1;
+
+    for( Mesh* pMesh : s_DynamicMeshes )
+    {
+        pMesh->FlushPendingUpdates( pArena );
+    }
+}
+
+void Mesh::FlushPendingUpdates(FrameArena* pArena)
+{
+    if( m_PendingVertsEnd > m_PendingVertsStart )
+    {
+        uint32 offset = m_PendingVertsStart * m_VertexStride;
+        uint32 size = (m_PendingVertsEnd - m_PendingVertsStart) * m_VertexStride;
+        bgfx::update( m_DynamicVBO[s_DynamicBufferIndex], m_PendingVertsStart, MakeUploadMemory( &m_VertexData[offset], size, pArena ) );
+    }
+
+    if( m_PendingIndicesEnd > m_PendingIndicesStart )
+    {
+        uint32 indexSize = m_Indices32 ? sizeof(uint32) : sizeof(uint16);
+        uint32 offset = m_PendingIndicesStart * indexSize;
+        uint32 size = (m_PendingIndicesEnd - m_PendingIndicesStart) * indexSize;
+        bgfx::update( m_DynamicIBO[s_DynamicBufferIndex], m_PendingIndicesStart, MakeUploadMemory( &m_IndexData[offset], size, pArena ) );
+    }
+
+    m_PendingVertsStart = m_PendingVertsEnd = 0;
+    m_PendingIndicesStart = m_PendingIndicesEnd = 0;
+}
+
+void Mesh::SetGeometry(const void* verts, uint32 numVerts, const void* indices, uint32 numIndices, FrameArena* pArena)
+{
+    UpdateVertices( 0, verts, numVerts, pArena );
+    UpdateIndices( 0, indices, numIndices, pArena );
+    SetDrawRange( 0, numIndices );
+}
+
+void Mesh::SetDrawRange(uint32 startIndex, uint32 numIndices)
+{
+    assert( m_Dynamic );
+    assert( startIndex + numIndices <= m_NumIndices );
+
+    m_SubMeshes[0] = { startIndex, numIndices };
+    m_LODs[0] = { startIndex, numIndices, 0.0f };
+}
+
+bool Mesh::LoadFromFile(const char* filename)
+{
+    Destroy();
+
+    MappedFile* pFile = MappedFile::Open( filename );
+    if( pFile == nullptr )
+    {
+        OutputMessage( "Failed to open mesh file: %s\n", filename );
+        return false;
+    }
+
+    const uint8* pData = pFile->GetData();
+    if( IsValidMeshFile( pData, pFile->GetSize() ) == false )
+    {
+        OutputMessage( "Invalid mesh file: %s\n", filename );
+        pFile->Release();
+        return false;
+    }
+
+    const MeshFileHeader* pHeader = reinterpret_cast<const MeshFileHeader*>( pData );
+
+    bgfx::VertexLayout vertexFormat;
+    ReadMeshFileLayout( pData, &vertexFormat );
+    if( vertexFormat.getStride() != pHeader->vertexStride )
+    {
+        OutputMessage( "Mesh file vertex layout doesn't match its stride: %s\n", filename );
+        pFile->Release();
+        return false;
+    }
+
+    m_Indices32 = (pHeader->flags & MeshFileFlag_Index32) != 0;
+    m_NumVerts = pHeader->numVertices;
+    m_NumIndices = pHeader->numIndices;
+    uint32 vertsSize = m_NumVerts * pHeader->vertexStride;
+    uint32 indicesSize = m_NumIndices * (m_Indices32 ? sizeof(uint32) : sizeof(uint16));
+
+    // No copies, each buffer holds a reference to the mapping until bgfx is done uploading it.
+    pFile->AddRef();
+    m_VBO = bgfx::createVertexBuffer( bgfx::makeRef( pData + pHeader->verticesOffset, vertsSize, ReleaseMappedFile, pFile ), vertexFormat );
+    pFile->AddRef();
+    m_IBO = bgfx::createIndexBuffer( bgfx::makeRef( pData + pHeader->indicesOffset, indicesSize, ReleaseMappedFile, pFile ), m_Indices32 ? BGFX_BUFFER_INDEX32 : BGFX_BUFFER_NONE );
+
+    const MeshFileSubMesh* pSubMeshes = reinterpret_cast<const MeshFileSubMesh*>( pData + pHeader->subMeshesOffset );
+    m_SubMeshes.clear();
+    for( uint32 i=0; i<pHeader->numSubMeshes; i++ )
+    {
+        m_SubMeshes.push_back( { pSubMeshes[i].startIndex, pSubMeshes[i].numIndices } );
+    }
+
+    // Each LOD's submeshes are contiguous, so it's drawn as a single index range.
+    m_LODs.clear();
+    for( const MeshFileLOD& fileLOD : ReadMeshFileLODs( pData ) )
+    {
+        const MeshFileSubMesh& first = pSubMeshes[fileLOD.firstSubMesh];
+        const MeshFileSubMesh& last = pSubMeshes[fileLOD.firstSubMesh + fileLOD.numSubMeshes - 1];
+        m_LODs.push_back( { first.startIndex, last.startIndex + last.numIndices - first.startIndex, fileLOD.minScreenSize } );
+    }
+
+    // Bounds were calculated when the file was saved.
+    m_BoundsCenter.Set( pHeader->boundsCenter[0], pHeader->boundsCenter[1], pHeader->boundsCenter[2] );
+    m_BoundsRadius = pHeader->boundsRadius;
+
+    pFile->Release();
+    return true;
+}
+
+void Mesh::SetLODs(const std::vector<LOD>& lods)
+{
+    assert( lods.empty() == false );
+    for( const LOD& lod : lods )
+    {
+        assert( lod.startIndex + lod.numIndices <= m_NumIndices );
+    }
+
+    m_LODs = lods;
+}
+
+uint32 Mesh::SelectLOD(float screenSize, uint32 currentLOD) const
+{
+    uint32 lastLOD = (uint32)m_LODs.size() - 1;
+    currentLOD = std::min( currentLOD, lastLOD );
+
+    uint32 target = 0;
+    while( target < lastLOD && screenSize < m_LODs[target].minScreenSize )
+    {
+        target++;
+    }
+
+    // Only switch once the size is clear of the threshold between the current LOD and its neighbour.
+    if( target > currentLOD && screenSize > m_LODs[currentLOD].minScreenSize * (1 - c_LODHysteresis) )
+        return currentLOD;
+    if( target < currentLOD && screenSize < m_LODs[currentLOD - 1].minScreenSize * (1 + c_LODHysteresis) )
+        return currentLOD;
+
+    return target;
+}
+
+// Called by bgfx, possibly from the render thread, once it's done with a makeRef'd buffer.
+void Mesh::ReleaseMappedFile(void* ptr, void* pUserData)
+{
+    static_cast<MappedFile*>( pUserData )->Release();
+}
+
+void Mesh::CalculateBounds(const bgfx::VertexLayout& vertexFormat, const void* verts, uint32 vertsSize, vec3* pCenter, float* pRadius)
+{
+    pCenter->Set( 0, 0, 0 );
+    *pRadius = -1;
+
+    if( vertexFormat.has( bgfx::Attrib::Position ) == false || vertexFormat.getStride() == 0 )
+        return;
+
+    uint32 numVerts = vertsSize / vertexFormat.getStride();
+    if( numVerts == 0 )
+        return;
+
+    // Center the sphere on the box around all the positions, then grow it to fit the furthest one.
+    float pos[4];
+    bgfx::vertexUnpack( pos, bgfx::Attrib::Position, vertexFormat, verts, 0 );
+    vec3 min( pos[0], pos[1], pos[2] );
+    vec3 max = min;
+    for( uint32 i=1; i<numVerts; i++ )
+    {
+        bgfx::vertexUnpack( pos, bgfx::Attrib::Position, vertexFormat, verts, i );
+        min.Set( std::min( min.x, pos[0] ), std::min( min.y, pos[1] ), std::min( min.z, pos[2] ) );
+        max.Set( std::max( max.x, pos[0] ), std::max( max.y, pos[1] ), std::max( max.z, pos[2] ) );
+    }
+    vec3 center = (min + max) * 0.5f;
+
+    float radiusSquared = 0;
+    for( uint32 i=0; i<numVerts; i++ )
+    {
+        bgfx::vertexUnpack( pos, bgfx::Attrib::Position, vertexFormat, verts, i );
+        radiusSquared = std::max( radiusSquared, (vec3( pos[0], pos[1], pos[2] ) - center).LengthSquared() );
+    }
+
+    *pCenter = center;
+    *pRadius = sqrtf( radiusSquared );
+}
+
+void Mesh::Draw(int viewID, const Uniforms* pUniforms, const Material* pMaterial, const mat4* worldMat, uint32 lod, vec4 lodFade)
+{
+    // On the main thread this returns bgfx's main encoder, same as using the global bgfx api.
+    bgfx::Encoder* pEncoder = bgfx::begin();
+    Draw( pEncoder, viewID, pUniforms, pMaterial, worldMat, lod, lodFade );
+    bgfx::end( pEncoder );
+}
+
+void Mesh::Draw(bgfx::Encoder* pEncoder, int viewID, const Uniforms* pUniforms, const Material* pMaterial, const mat4* worldMat, uint32 lod, vec4 lodFade)
+{
+    Draw( pEncoder, viewID, pUniforms, GetDrawState( lod ), pMaterial->GetDrawState(), worldMat, lodFade );
 }
 
-void Mesh::Create(const bgfx::VertexLayout& vertexFormat, const void* verts, uint32 vertsSize, const void* indices, uint32 indicesSize)
+Mesh::DrawState Mesh::GetDrawState(uint32 lod) const
 {
-    m_VBO = bgfx::createVertexBuffer( bgfx::makeRef(verts, vertsSize), vertexFormat );
-    m_IBO = bgfx::createIndexBuffer( bgfx::makeRef(indices, indicesSize) );
+    const LOD& lodRange = m_LODs[std::min( lod, (uint32)m_LODs.size() - 1 )];
+
+    DrawState state;
+    state.vbo = m_VBO;
+    state.ibo = m_IBO;
+    state.dynamicVBO = m_DynamicVBO[s_DynamicBufferIndex];
+    state.dynamicIBO = m_DynamicIBO[s_DynamicBufferIndex];
+    state.startIndex = lodRange.startIndex;
+    state.numIndices = lodRange.numIndices;
+    state.numVerts = m_NumVerts;
+    return state;
 }
 
-void Mesh::Draw(int viewID, const Uniforms* pUniforms, const Material* pMaterial, const mat4* worldMat)
+void Mesh::Draw(bgfx::Encoder* pEncoder, int viewID, const Uniforms* pUniforms, const DrawState& mesh, const Material::DrawState& material, const mat4* worldMat, vec4 lodFade)
 {
+    if( mesh.numIndices == 0 )
+        return;
+
     // Set vertex and index buffer.
-    bgfx::setVertexBuffer( 0, m_VBO );
-    bgfx::setIndexBuffer( m_IBO );
+    if( bgfx::isValid( mesh.dynamicVBO ) )
+    {
+        pEncoder->setVertexBuffer( 0, mesh.dynamicVBO, 0, mesh.numVerts );
+        pEncoder->setIndexBuffer( mesh.dynamicIBO, mesh.startIndex, mesh.numIndices );
+    }
+    else
+    {
+        pEncoder->setVertexBuffer( 0, mesh.vbo );
+        pEncoder->setIndexBuffer( mesh.ibo, mesh.startIndex, mesh.numIndices );
+    }
 
     // Setup the material's uniforms.
-    pMaterial->Enable( pUniforms );
+    Material::Enable( pEncoder, pUniforms, material );
+    pEncoder->setUniform( pUniforms->m_Map.at( "u_LODFade" ), &lodFade.x );
 
     // Set render states.
-    uint64_t state = pMaterial->GetBGFXRenderState() | BGFX_STATE_MSAA;
-    bgfx::setState( state );
+    uint64_t state = material.renderState | BGFX_STATE_MSAA;
+    pEncoder->setState( state );
 
     if( worldMat )
     {
-        bgfx::setTransform( &worldMat->m11 );
+        pEncoder->setTransform( &worldMat->m11 );
     }
 
     // Submit primitive for rendering to the current view.
-    bgfx::submit( viewID, pMaterial->GetShader()->GetProgram() );
+    pEncoder->submit( viewID, material.program );
 }
 
 void Mesh::Editor_DisplayProperties()
@@ -65,8 +429,27 @@ void Mesh::Editor_DisplayProperties()
     ImGui::Text( "Mesh: %s", m_Name );
     ImGui::Separator();
 
-    ImGui::Text( "VBO: %d", m_VBO.idx );
-    ImGui::Text( "IBO: %d", m_IBO.idx );
+    if( m_Dynamic )
+    {
+        ImGui::Text( "Dynamic VBOs: %d, %d", m_DynamicVBO[0].idx, m_DynamicVBO[1].idx );
+        ImGui::Text( "Dynamic IBOs: %d, %d (%s indices)", m_DynamicIBO[0].idx, m_DynamicIBO[1].idx, m_Indices32 ? "32-bit" : "16-bit" );
+    }
+    else
+    {
+        ImGui::Text( "VBO: %d", m_VBO.idx );
+        ImGui::Text( "IBO: %d (%s indices)", m_IBO.idx, m_Indices32 ? "32-bit" : "16-bit" );
+    }
+    ImGui::Text( "Vertices: %d, Indices: %d, SubMeshes: %d", m_NumVerts, m_NumIndices, (int)m_SubMeshes.size() );
+
+    for( uint32 i=0; i<m_LODs.size(); i++ )
+    {
+        ImGui::Text( "LOD %d: %d triangles, min screen size %0.3f", i, m_LODs[i].numIndices / 3, m_LODs[i].minScreenSize );
+    }
+
+    if( HasBounds() )
+    {
+        ImGui::Text( "Bounds: (%0.2f, %0.2f, %0.2f) radius %0.2f", m_BoundsCenter.x, m_BoundsCenter.y, m_BoundsCenter.z, m_BoundsRadius );
+    }
 }
 
 } // namespace fw
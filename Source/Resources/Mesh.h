@@ -12,30 +12,156 @@
 #include "bgfx/platform.h"
 #include "Math/Vector.h"
 #include "Math/Matrix.h"
+#include "Resources/Material.h"
 #include "Resources/Resource.h"
 
 namespace fw {
 
-class Material;
+class FrameArena;
+class MappedFile;
 class ShaderProgram;
 class Uniforms;
 
 class Mesh : public Resource
 {
 public:
-    Mesh(const char* name, const bgfx::VertexLayout& vertexFormat, const void* verts, uint32 vertsSize, const void* indices, uint32 indicesSize);
+    struct SubMesh
+    {
+        uint32 startIndex;
+        uint32 numIndices;
+    };
+
+    // A run of indices drawn instead of the full mesh once it's small enough on screen.
+    // Screen size is the height of the mesh's bounding sphere over the height of the view, so 1 fills the view.
+    // LOD 0 is the most detailed, each LOD is used while the screen size is at least its minScreenSize.
+    struct LOD
+    {
+        uint32 startIndex;
+        uint32 numIndices;
+        float minScreenSize;
+    };
+
+    // How far past a LOD's threshold the screen size must move before switching, as a fraction of the threshold.
+    // Stops meshes sitting near a threshold from flickering between LODs.
+    static constexpr float c_LODHysteresis = 0.1f;
+
+    // Everything a draw reads from the mesh, its buffers and the index range of a LOD.
+    // RenderSnapshot keeps a copy, so the mesh can change or be deleted before the snapshot is submitted.
+    // The dynamic handles are only valid for dynamic meshes.
+    struct DrawState
+    {
+        bgfx::VertexBufferHandle vbo;
+        bgfx::IndexBufferHandle ibo;
+        bgfx::DynamicVertexBufferHandle dynamicVBO;
+        bgfx::DynamicIndexBufferHandle dynamicIBO;
+        uint32 startIndex;
+        uint32 numIndices;
+        uint32 numVerts;
+    };
+
+public:
+    // The vertex and index data is copied, so the caller's arrays can be freed right away.
+    Mesh(const char* name, const bgfx::VertexLayout& vertexFormat, const void* verts, uint32 vertsSize, const void* indices, uint32 indicesSize, bool indices32 = false);
+    // Loads a mesh file (see MeshFormat.h), bgfx reads the buffers straight out of the mapped file.
+    Mesh(const char* name, const char* filename);
+    // Creates a dynamic mesh, see CreateDynamic.
+    Mesh(const char* name, const bgfx::VertexLayout& vertexFormat, uint32 maxVerts, uint32 maxIndices, bool indices32 = false);
     virtual ~Mesh();
 
-    void Create(const bgfx::VertexLayout& vertexFormat, const void* verts, uint32 vertsSize, const void* indices, uint32 indicesSize);
+    void Create(const bgfx::VertexLayout& vertexFormat, const void* verts, uint32 vertsSize, const void* indices, uint32 indicesSize, bool indices32 = false);
+    bool LoadFromFile(const char* filename);
+
+    // Dynamic meshes keep their buffers and handles, and have parts of them rewritten with the Update functions.
+    // The buffers start out empty with room for maxVerts and maxIndices, and grow if an update goes past the end.
+    // Only the range set with SetDrawRange is drawn, nothing until it's set.
+    // They have no bounds, so they're never culled, unless SetBounds is called.
+    //
+    // With a FrameArena the data is copied into it and handed to bgfx by reference, which stays valid until
+    //   bgfx is done with it, so updates every frame don't allocate. Without one, bgfx makes its own copy.
+    //
+    // With pipelined rendering, a snapshot is submitted while the following frame updates, so each dynamic mesh
+    //   keeps two pairs of buffers and alternates between them every frame (see SwapDynamicBuffers).
+    //   Updates go to this frame's pair right away and to the other pair after the next bgfx::frame,
+    //   from a CPU copy, so a snapshot always draws the geometry that matches the range it recorded.
+    // CreateDynamic can't be called on a mesh that's already dynamic, the buffers grow as needed instead.
+    void CreateDynamic(const bgfx::VertexLayout& vertexFormat, uint32 maxVerts, uint32 maxIndices, bool indices32 = false);
+    void UpdateVertices(uint32 startVertex, const void* verts, uint32 numVerts, FrameArena* pArena = nullptr);
+    void UpdateIndices(uint32 startIndex, const void* indices, uint32 numIndices, FrameArena* pArena = nullptr);
+    // Replaces everything, starting at the first vertex and index, and draws all of it.
+    void SetGeometry(const void* verts, uint32 numVerts, const void* indices, uint32 numIndices, FrameArena* pArena = nullptr);
+    void SetDrawRange(uint32 startIndex, uint32 numIndices);
+    void SetBounds(vec3 center, float radius) { m_BoundsCenter = center; m_BoundsRadius = radius; }
+    bool IsDynamic() { return m_Dynamic; }
+    // Called by FWCore after bgfx::frame, switches dynamic meshes to their other buffers
+    //   and copies last frame's updates into them. Main thread only, like the Update functions.
+    static void SwapDynamicBuffers(FrameArena* pArena);
+
+    // lodFade is passed to shaders as u_LODFade for dithered cross-fades between LODs.
+    // x is how much of the LOD to draw: shaders should discard pixels whose 0-1 dither value is >= x,
+    //   or whose 1-dither is >= x when y is 1, so the outgoing LOD fills the pixels the incoming one skips.
+    void Draw(int viewID, const Uniforms* pUniforms, const Material* pMaterial, const mat4* worldMat, uint32 lod = 0, vec4 lodFade = vec4(1,0,0,0));
+    void Draw(bgfx::Encoder* pEncoder, int viewID, const Uniforms* pUniforms, const Material* pMaterial, const mat4* worldMat, uint32 lod = 0, vec4 lodFade = vec4(1,0,0,0));
+    // Draws from copied states without touching the mesh or material, so it's safe after either has changed.
+    static void Draw(bgfx::Encoder* pEncoder, int viewID, const Uniforms* pUniforms, const DrawState& mesh, const Material::DrawState& material, const mat4* worldMat, vec4 lodFade);
+    DrawState GetDrawState(uint32 lod) const;
+
+    // Local space bounding sphere, built from the vertex positions in Create.
+    // The radius is negative if the layout has no positions, such meshes are never culled.
+    bool HasBounds() { return m_BoundsRadius >= 0; }
+    vec3 GetBoundsCenter() { return m_BoundsCenter; }
+    float GetBoundsRadius() { return m_BoundsRadius; }
+    // Bounding sphere of the positions in a vertex buffer, the radius is negative if there aren't any.
+    static void CalculateBounds(const bgfx::VertexLayout& vertexFormat, const void* verts, uint32 vertsSize, vec3* pCenter, float* pRadius);
 
-    void Draw(int viewID, const Uniforms* pUniforms, const Material* pMaterial, const mat4* worldMat);
+    // Meshes created from memory have a single submesh covering all the indices.
+    uint32 GetNumSubMeshes() { return (uint32)m_SubMeshes.size(); }
+    const SubMesh& GetSubMesh(uint32 index) { return m_SubMeshes[index]; }
+
+    // Meshes created from memory have a single LOD until SetLODs is called.
+    uint32 GetNumLODs() const { return (uint32)m_LODs.size(); }
+    const LOD& GetLOD(uint32 index) const { return m_LODs[index]; }
+    void SetLODs(const std::vector<LOD>& lods);
+    // Returns the LOD to draw at a screen size, given the one drawn last frame.
+    uint32 SelectLOD(float screenSize, uint32 currentLOD) const;
 
     // Editor.
     virtual void Editor_DisplayProperties() override;
     
 protected:
-    bgfx::VertexBufferHandle m_VBO;
-    bgfx::IndexBufferHandle m_IBO;
+    void Destroy();
+
+    static void ReleaseMappedFile(void* ptr, void* pUserData);
+    static const bgfx::Memory* MakeUploadMemory(const void* pData, uint32 size, FrameArena* pArena);
+    void FlushPendingUpdates(FrameArena* pArena);
+
+protected:
+    bgfx::VertexBufferHandle m_VBO = BGFX_INVALID_HANDLE;
+    bgfx::IndexBufferHandle m_IBO = BGFX_INVALID_HANDLE;
+
+    // Dynamic meshes draw from pair [s_DynamicBufferIndex], the other pair is still in use by the previous snapshot.
+    // m_VertexData and m_IndexData hold everything uploaded, the pending ranges are what the other pair is missing.
+    bool m_Dynamic = false;
+    bgfx::DynamicVertexBufferHandle m_DynamicVBO[2] = { BGFX_INVALID_HANDLE, BGFX_INVALID_HANDLE };
+    bgfx::DynamicIndexBufferHandle m_DynamicIBO[2] = { BGFX_INVALID_HANDLE, BGFX_INVALID_HANDLE };
+    uint32 m_VertexStride = 0;
+    std::vector<uint8> m_VertexData;
+    std::vector<uint8> m_IndexData;
+    uint32 m_PendingVertsStart = 0;
+    uint32 m_PendingVertsEnd = 0;
+    uint32 m_PendingIndicesStart = 0;
+    uint32 m_PendingIndicesEnd = 0;
+
+    static uint32 s_DynamicBufferIndex;
+    static std::vector<Mesh*> s_DynamicMeshes;
+
+    uint32 m_NumVerts = 0;
+    uint32 m_NumIndices = 0;
+    bool m_Indices32 = false;
+    std::vector<SubMesh> m_SubMeshes;
+    std::vector<LOD> m_LODs;
+
+    vec3 m_BoundsCenter = vec3(0,0,0);
+    float m_BoundsRadius = -1;
 };
 
 } // namespace fw
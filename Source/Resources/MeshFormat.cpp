@@ -0,0 +1,211 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "CoreHeaders.h"
+
+#include "MeshFormat.h"
+#include "Resources/Mesh.h"
+#include "Utility/Utility.h"
+
+namespace fw {
+
+static uint32 AlignTo16(uint32 value)
+{
+    return (value + 15) & ~15u;
+}
+
+// Version 1 headers end before numLODs.
+static const size_t c_MeshFileHeaderSizeV1 = offsetof(MeshFileHeader, numLODs);
+
+bool SaveMeshFile(const char* filename, const bgfx::VertexLayout& layout, const void* verts, uint32 numVerts, const uint32* indices, uint32 numIndices, const std::vector<MeshFileSubMesh>& subMeshes, const std::vector<MeshFileLOD>& lods)
+{
+    std::vector<MeshFileAttribute> attributes;
+    for( int i=0; i<bgfx::Attrib::Count; i++ )
+    {
+        bgfx::Attrib::Enum attrib = (bgfx::Attrib::Enum)i;
+        if( layout.has( attrib ) == false )
+            continue;
+
+        uint8 num;
+        bgfx::AttribType::Enum type;
+        bool normalized;
+        bool asInt;
+        layout.decode( attrib, num, type, normalized, asInt );
+
+        MeshFileAttribute attribute = {};
+        attribute.attrib = (uint8)attrib;
+        attribute.type = (uint8)type;
+        attribute.num = num;
+        attribute.normalized = normalized;
+        attribute.asInt = asInt;
+        attribute.offset = layout.getOffset( attrib );
+        attributes.push_back( attribute );
+    }
+
+    MeshFileSubMesh wholeMesh = { 0, numIndices };
+    const MeshFileSubMesh* pSubMeshes = subMeshes.empty() ? &wholeMesh : subMeshes.data();
+    uint32 numSubMeshes = subMeshes.empty() ? 1 : (uint32)subMeshes.size();
+
+    MeshFileLOD singleLOD = { 0, numSubMeshes, 0.0f };
+    const MeshFileLOD* pLODs = lods.empty() ? &singleLOD : lods.data();
+    uint32 numLODs = lods.empty() ? 1 : (uint32)lods.size();
+
+    // 16-bit indices can address 65536 vertices.
+    bool index32 = numVerts > 0x10000;
+    uint32 indexSize = index32 ? sizeof(uint32) : sizeof(uint16);
+
+    MeshFileHeader header = {};
+    header.magic = c_MeshFileMagic;
+    header.version = c_MeshFileVersion;
+    header.flags = index32 ? MeshFileFlag_Index32 : 0;
+    header.numVertices = numVerts;
+    header.vertexStride = layout.getStride();
+    header.numIndices = numIndices;
+    header.numAttributes = (uint32)attributes.size();
+    header.numSubMeshes = numSubMeshes;
+    header.numLODs = numLODs;
+
+    vec3 boundsCenter;
+    Mesh::CalculateBounds( layout, verts, numVerts * layout.getStride(), &boundsCenter, &header.boundsRadius );
+    header.boundsCenter[0] = boundsCenter.x;
+    header.boundsCenter[1] = boundsCenter.y;
+    header.boundsCenter[2] = boundsCenter.z;
+
+    header.attributesOffset = sizeof(MeshFileHeader);
+    header.subMeshesOffset = header.attributesOffset + header.numAttributes * sizeof(MeshFileAttribute);
+    header.lodsOffset = header.subMeshesOffset + numSubMeshes * sizeof(MeshFileSubMesh);
+    header.verticesOffset = AlignTo16( header.lodsOffset + numLODs * sizeof(MeshFileLOD) );
+    header.indicesOffset = AlignTo16( header.verticesOffset + numVerts * header.vertexStride );
+    uint32 fileSize = header.indicesOffset + numIndices * indexSize;
+
+    // Build the whole file in memory, padding between sections is left as zeros.
+    std::vector<uint8> buffer( fileSize, 0 );
+    memcpy( &buffer[0], &header, sizeof(header) );
+    if( attributes.empty() == false )
+        memcpy( &buffer[header.attributesOffset], attributes.data(), attributes.size() * sizeof(MeshFileAttribute) );
+    memcpy( &buffer[header.subMeshesOffset], pSubMeshes, numSubMeshes * sizeof(MeshFileSubMesh) );
+    memcpy( &buffer[header.lodsOffset], pLODs, numLODs * sizeof(MeshFileLOD) );
+    memcpy( &buffer[header.verticesOffset], verts, numVerts * header.vertexStride );
+
+    if( index32 )
+    {
+        memcpy( &buffer[header.indicesOffset], indices, numIndices * sizeof(uint32) );
+    }
+    else
+    {
+        uint16* pIndices16 = reinterpret_cast<uint16*>( &buffer[header.indicesOffset] );
+        for( uint32 i=0; i<numIndices; i++ )
+        {
+            pIndices16[i] = (uint16)indices[i];
+        }
+    }
+
+    FILE* fileHandle = OpenFile( filename, "wb" );
+    if( fileHandle == nullptr )
+        return false;
+
+    size_t written = fwrite( buffer.data(), 1, buffer.size(), fileHandle );
+    fclose( fileHandle );
+
+    return written == buffer.size();
+}
+
+bool IsValidMeshFile(const uint8* pData, size_t size)
+{
+    if( size < c_MeshFileHeaderSizeV1 )
+        return false;
+
+    const MeshFileHeader* pHeader = reinterpret_cast<const MeshFileHeader*>( pData );
+    if( pHeader->magic != c_MeshFileMagic || pHeader->version == 0 || pHeader->version > c_MeshFileVersion )
+        return false;
+
+    if( pHeader->version >= 2 && size < sizeof(MeshFileHeader) )
+        return false;
+
+    if( pHeader->numAttributes == 0 || pHeader->numAttributes > bgfx::Attrib::Count || pHeader->numSubMeshes == 0 )
+        return false;
+
+    // bgfx reads the buffers directly from the file, keep them aligned.
+    if( (pHeader->verticesOffset & 15) != 0 || (pHeader->indicesOffset & 15) != 0 )
+        return false;
+
+    // 64-bit math so corrupt counts can't wrap around.
+    uint64 indexSize = (pHeader->flags & MeshFileFlag_Index32) ? sizeof(uint32) : sizeof(uint16);
+    uint64 attributesEnd = (uint64)pHeader->attributesOffset + (uint64)pHeader->numAttributes * sizeof(MeshFileAttribute);
+    uint64 subMeshesEnd = (uint64)pHeader->subMeshesOffset + (uint64)pHeader->numSubMeshes * sizeof(MeshFileSubMesh);
+    uint64 verticesEnd = (uint64)pHeader->verticesOffset + (uint64)pHeader->numVertices * pHeader->vertexStride;
+    uint64 indicesEnd = (uint64)pHeader->indicesOffset + (uint64)pHeader->numIndices * indexSize;
+    if( attributesEnd > size || subMeshesEnd > size || verticesEnd > size || indicesEnd > size )
+        return false;
+
+    const MeshFileAttribute* pAttributes = reinterpret_cast<const MeshFileAttribute*>( pData + pHeader->attributesOffset );
+    for( uint32 i=0; i<pHeader->numAttributes; i++ )
+    {
+        if( pAttributes[i].attrib >= bgfx::Attrib::Count || pAttributes[i].type >= bgfx::AttribType::Count )
+            return false;
+    }
+
+    const MeshFileSubMesh* pSubMeshes = reinterpret_cast<const MeshFileSubMesh*>( pData + pHeader->subMeshesOffset );
+    for( uint32 i=0; i<pHeader->numSubMeshes; i++ )
+    {
+        if( (uint64)pSubMeshes[i].startIndex + pSubMeshes[i].numIndices > pHeader->numIndices )
+            return false;
+    }
+
+    if( pHeader->version >= 2 )
+    {
+        uint64 lodsEnd = (uint64)pHeader->lodsOffset + (uint64)pHeader->numLODs * sizeof(MeshFileLOD);
+        if( pHeader->numLODs == 0 || lodsEnd > size )
+            return false;
+
+        const MeshFileLOD* pLODs = reinterpret_cast<const MeshFileLOD*>( pData + pHeader->lodsOffset );
+        for( uint32 i=0; i<pHeader->numLODs; i++ )
+        {
+            if( pLODs[i].numSubMeshes == 0 || (uint64)pLODs[i].firstSubMesh + pLODs[i].numSubMeshes > pHeader->numSubMeshes )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+std::vector<MeshFileLOD> ReadMeshFileLODs(const uint8* pData)
+{
+    const MeshFileHeader* pHeader = reinterpret_cast<const MeshFileHeader*>( pData );
+    if( pHeader->version < 2 )
+        return { { 0, pHeader->numSubMeshes, 0.0f } };
+
+    const MeshFileLOD* pLODs = reinterpret_cast<const MeshFileLOD*>( pData + pHeader->lodsOffset );
+    return std::vector<MeshFileLOD>( pLODs, pLODs + pHeader->numLODs );
+}
+
+void ReadMeshFileLayout(const uint8* pData, bgfx::VertexLayout* pLayout)
+{
+    const MeshFileHeader* pHeader = reinterpret_cast<const MeshFileHeader*>( pData );
+    const MeshFileAttribute* pAttributes = reinterpret_cast<const MeshFileAttribute*>( pData + pHeader->attributesOffset );
+
+    // Add attributes in memory order, skipping any gaps, so the offsets match the ones that were saved.
+    std::vector<MeshFileAttribute> attributes( pAttributes, pAttributes + pHeader->numAttributes );
+    std::sort( attributes.begin(), attributes.end(),
+        [](const MeshFileAttribute& a, const MeshFileAttribute& b) { return a.offset < b.offset; } );
+
+    pLayout->begin();
+    for( const MeshFileAttribute& attribute : attributes )
+    {
+        if( attribute.offset > pLayout->getStride() )
+            pLayout->skip( (uint8)(attribute.offset - pLayout->getStride()) );
+
+        pLayout->add( (bgfx::Attrib::Enum)attribute.attrib, attribute.num, (bgfx::AttribType::Enum)attribute.type, attribute.normalized != 0, attribute.asInt != 0 );
+    }
+    if( pHeader->vertexStride > pLayout->getStride() )
+        pLayout->skip( (uint8)(pHeader->vertexStride - pLayout->getStride()) );
+    pLayout->end();
+}
+
+} // namespace fw
@@ -0,0 +1,101 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#pragma once
+
+#include "bgfx/bgfx.h"
+#include "Math/Vector.h"
+
+namespace fw {
+
+// Binary mesh file, loaded by Mesh( name, filename ).
+// Everything is little endian and laid out so vertex and index data can be handed to bgfx straight from a
+//   memory mapped file:
+//    MeshFileHeader
+//    MeshFileAttribute[numAttributes]
+//    MeshFileSubMesh[numSubMeshes]
+//    MeshFileLOD[numLODs] (version 2+)
+//    vertex data, 16 byte aligned
+//    index data, 16 byte aligned, uint16 or uint32 depending on MeshFileFlag_Index32
+// Attributes store bgfx's Attrib and AttribType values, so bump the version if bgfx reorders those enums.
+// LODs share the vertex data, each one is a run of submeshes whose indices follow the previous LOD's.
+// Version 1 files have no LODs, their header ends before numLODs and they load as a single LOD.
+
+static const uint32 c_MeshFileMagic = 'F' | ('W' << 8) | ('M' << 16) | ('S' << 24);
+static const uint32 c_MeshFileVersion = 2;
+
+enum MeshFileFlag
+{
+    MeshFileFlag_Index32 = 1 << 0,
+};
+
+struct MeshFileHeader
+{
+    uint32 magic;
+    uint32 version;
+    uint32 flags;
+    uint32 numVertices;
+    uint32 vertexStride;
+    uint32 numIndices;
+    uint32 numAttributes;
+    uint32 numSubMeshes;
+
+    float boundsCenter[3];
+    float boundsRadius; // Negative if the mesh has no positions.
+
+    // Offsets from the start of the file.
+    uint32 attributesOffset;
+    uint32 subMeshesOffset;
+    uint32 verticesOffset;
+    uint32 indicesOffset;
+
+    // Version 2.
+    uint32 numLODs;
+    uint32 lodsOffset;
+};
+
+struct MeshFileAttribute
+{
+    uint8 attrib;       // bgfx::Attrib::Enum.
+    uint8 type;         // bgfx::AttribType::Enum.
+    uint8 num;
+    uint8 normalized;
+    uint8 asInt;
+    uint8 padding;
+    uint16 offset;      // Byte offset within a vertex.
+};
+
+struct MeshFileSubMesh
+{
+    uint32 startIndex;
+    uint32 numIndices;
+};
+
+struct MeshFileLOD
+{
+    uint32 firstSubMesh;
+    uint32 numSubMeshes;
+    float minScreenSize; // See Mesh::LOD.
+};
+
+// Writes a mesh file. Indices are stored as 16-bit when every vertex can be addressed with them, 32-bit otherwise.
+// An empty subMeshes list writes a single submesh covering all the indices, an empty lods list a single LOD covering all the submeshes.
+// Returns false if the file couldn't be written.
+bool SaveMeshFile(const char* filename, const bgfx::VertexLayout& layout, const void* verts, uint32 numVerts, const uint32* indices, uint32 numIndices, const std::vector<MeshFileSubMesh>& subMeshes, const std::vector<MeshFileLOD>& lods = {});
+
+// Checks the header and that every section lies inside the file.
+bool IsValidMeshFile(const uint8* pData, size_t size);
+
+// Rebuilds the vertex layout described by a valid mesh file.
+void ReadMeshFileLayout(const uint8* pData, bgfx::VertexLayout* pLayout);
+
+// Reads the LODs of a valid mesh file, version 1 files return a single LOD covering all the submeshes.
+std::vector<MeshFileLOD> ReadMeshFileLODs(const uint8* pData);
+
+} // namespace fw
@@ -15,6 +15,8 @@
 #include "Resources/ShaderProgram.h"
 #include "Resources/SpriteSheet.h"
 #include "Resources/Texture.h"
+#include "Utility/AllocationTracker.h"
+#include "Utility/Profiler.h"
 
 namespace fw {
 
@@ -47,14 +49,17 @@ void ResourceManager::AddTexture(Texture* pTexture)             { AddResource( R
 void ResourceManager::AddMaterial(Material* pMaterial)          { AddResource( ResourceType::Material, pMaterial ); }
 void ResourceManager::AddSpriteSheet(SpriteSheet* pSpriteSheet) { AddResource( ResourceType::SpriteSheet, pSpriteSheet ); }
 
-Mesh* ResourceManager::GetMesh(std::string name)                { return static_cast<Mesh*>( GetResource( ResourceType::Mesh, name ) ); }
-ShaderProgram* ResourceManager::GetShader(std::string name)     { return static_cast<ShaderProgram*>( GetResource( ResourceType::Shader, name ) ); }
-Texture* ResourceManager::GetTexture(std::string name)          { return static_cast<Texture*>( GetResource( ResourceType::Texture, name ) ); }
-Material* ResourceManager::GetMaterial(std::string name)        { return static_cast<Material*>( GetResource( ResourceType::Material, name ) ); }
-SpriteSheet* ResourceManager::GetSpriteSheet(std::string name)  { return static_cast<SpriteSheet*>( GetResource( ResourceType::SpriteSheet, name ) ); }
+Mesh* ResourceManager::GetMesh(const std::string& name)                { return static_cast<Mesh*>( GetResource( ResourceType::Mesh, name ) ); }
+ShaderProgram* ResourceManager::GetShader(const std::string& name)     { return static_cast<ShaderProgram*>( GetResource( ResourceType::Shader, name ) ); }
+Texture* ResourceManager::GetTexture(const std::string& name)          { return static_cast<Texture*>( GetResource( ResourceType::Texture, name ) ); }
+Material* ResourceManager::GetMaterial(const std::string& name)        { return static_cast<Material*>( GetResource( ResourceType::Material, name ) ); }
+SpriteSheet* ResourceManager::GetSpriteSheet(const std::string& name)  { return static_cast<SpriteSheet*>( GetResource( ResourceType::SpriteSheet, name ) ); }
 
 void ResourceManager::AddResource(ResourceType type, Resource* pResource)
 {
+    FW_PROFILE_SCOPE( "ResourceManager::AddResource" );
+    FW_ALLOC_TAG( AllocationTag::Resources );
+
     std::map<std::string, Resource*>& list = m_Resources[type];
 
     const char* name = pResource->GetName();
@@ -64,8 +69,11 @@ void ResourceManager::AddResource(ResourceType type, Resource* pResource)
     }
 }
 
-Resource* ResourceManager::GetResource(ResourceType type, std::string name)
+Resource* ResourceManager::GetResource(ResourceType type, const std::string& name)
 {
+    FW_PROFILE_SCOPE( "ResourceManager::GetResource" );
+    FW_ALLOC_TAG( AllocationTag::Resources );
+
     std::map<std::string, Resource*>& list = m_Resources[type];
 
     if( list.find(name) != list.end() )
@@ -76,6 +84,55 @@ Resource* ResourceManager::GetResource(ResourceType type, std::string name)
     return nullptr;    
 }
 
+uint32 ResourceManager::GetNumResources()
+{
+    uint32 count = 0;
+    for( auto& mapPair : m_Resources )
+    {
+        count += (uint32)mapPair.second.size();
+    }
+
+    return count;
+}
+
+uint32 ResourceManager::RemapMaterialsToAtlas(SpriteSheet* pAtlas)
+{
+    FW_PROFILE_SCOPE( "ResourceManager::RemapMaterialsToAtlas" );
+
+    Texture* pAtlasTexture = pAtlas->GetTexture();
+
+    uint32 count = 0;
+    for( auto& resourcePair : m_Resources[ResourceType::Material] )
+    {
+        Material* pMaterial = static_cast<Material*>( resourcePair.second );
+
+        Texture* pTexture = pMaterial->GetTextureColor();
+        if( pTexture == nullptr || pTexture == pAtlasTexture )
+            continue;
+
+        SpriteSheet::SpriteID id = pAtlas->GetSpriteID( pTexture->GetName() );
+        if( id == SpriteSheet::c_InvalidSpriteID )
+            continue;
+
+        // UVs outside 0-1 would sample neighbouring sprites.
+        // Mesh UVs are 0-1, so they cover offset to offset+scale, which is reversed for a negative scale.
+        vec4 uvScaleOffset = pMaterial->GetUVScaleOffset();
+        vec2 uvScale( uvScaleOffset.x, uvScaleOffset.y );
+        vec2 uvOffset( uvScaleOffset.z, uvScaleOffset.w );
+        vec2 uvMin( uvOffset.x + std::min( uvScale.x, 0.0f ), uvOffset.y + std::min( uvScale.y, 0.0f ) );
+        vec2 uvMax( uvOffset.x + std::max( uvScale.x, 0.0f ), uvOffset.y + std::max( uvScale.y, 0.0f ) );
+        if( uvMin.x < 0 || uvMin.y < 0 || uvMax.x > 1 || uvMax.y > 1 )
+            continue;
+
+        const SpriteSheet::SpriteInfo& sprite = pAtlas->GetSprite( id );
+        pMaterial->SetTextureColor( pAtlasTexture );
+        pMaterial->SetUVScaleOffset( uvScale * sprite.uvScale, sprite.uvOffset + uvOffset * sprite.uvScale );
+        count++;
+    }
+
+    return count;
+}
+
 void ResourceManager::Editor_DisplayResources()
 {
     ImGuiTabBarFlags tab_bar_flags = ImGuiTabBarFlags_None;
@@ -42,18 +42,26 @@ public:
     void AddMaterial(Material* pMaterial);
     void AddSpriteSheet(SpriteSheet* pSpriteSheet);
 
-    Mesh* GetMesh(std::string name);
-    ShaderProgram* GetShader(std::string name);
-    Texture* GetTexture(std::string name);
-    Material* GetMaterial(std::string name);
-    SpriteSheet* GetSpriteSheet(std::string name);
+    Mesh* GetMesh(const std::string& name);
+    ShaderProgram* GetShader(const std::string& name);
+    Texture* GetTexture(const std::string& name);
+    Material* GetMaterial(const std::string& name);
+    SpriteSheet* GetSpriteSheet(const std::string& name);
+
+    uint32 GetNumResources();
+
+    // Points materials at an atlas built by AtlasBuilder instead of their loose textures.
+    // A material is remapped if its color texture's name matches a sprite name in the atlas,
+    //   its UV scale/offset is folded into the sprite's rect. Materials whose UVs reach outside 0-1 are skipped.
+    // Returns the number of materials remapped.
+    uint32 RemapMaterialsToAtlas(SpriteSheet* pAtlas);
 
     void Editor_DisplayResources();
     void Editor_DisplaySelectedResource();
 
 protected:
     void AddResource(ResourceType type, Resource* pResource);
-    Resource* GetResource(ResourceType type, std::string name);
+    Resource* GetResource(ResourceType type, const std::string& name);
     
     std::map<ResourceType, std::map<std::string, Resource*>> m_Resources;
 
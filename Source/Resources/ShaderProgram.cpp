@@ -13,6 +13,8 @@
 #include "imgui.h"
 
 #include "ShaderProgram.h"
+#include "Utility/AllocationTracker.h"
+#include "Utility/Profiler.h"
 #include "Utility/Utility.h"
 
 namespace fw {
@@ -50,9 +52,17 @@ void ShaderProgram::Cleanup()
     if( m_FragShaderString )
         delete[] m_FragShaderString;
 
-    bgfx::destroy( m_Program );
-    bgfx::destroy( m_VertShader );
-    bgfx::destroy( m_FragShader );
+    // Shaders created by name only never load a program.
+    if( bgfx::isValid( m_Program ) )
+        bgfx::destroy( m_Program );
+    if( bgfx::isValid( m_VertShader ) )
+        bgfx::destroy( m_VertShader );
+    if( bgfx::isValid( m_FragShader ) )
+        bgfx::destroy( m_FragShader );
+
+    m_Program = BGFX_INVALID_HANDLE;
+    m_VertShader = BGFX_INVALID_HANDLE;
+    m_FragShader = BGFX_INVALID_HANDLE;
 
     m_VertShaderString = nullptr;
     m_FragShaderString = nullptr;
@@ -60,6 +70,9 @@ void ShaderProgram::Cleanup()
 
 bool ShaderProgram::Init(const char* shaderFolder, const char* vertFilename, const char* fragFilename)
 {
+    FW_PROFILE_SCOPE( "ShaderProgram::Init" );
+    FW_ALLOC_TAG( AllocationTag::Resources );
+
     char vertFullPath[MAX_PATH];
     char fragFullPath[MAX_PATH];
 
@@ -82,8 +95,8 @@ bool ShaderProgram::Init(const char* shaderFolder, const char* vertFilename, con
         break;
     }
 
-    sprintf_s( vertFullPath, MAX_PATH, "%s/%s/%s", shaderFolder, rendererPath, vertFilename );
-    sprintf_s( fragFullPath, MAX_PATH, "%s/%s/%s", shaderFolder, rendererPath, fragFilename );
+    snprintf( vertFullPath, MAX_PATH, "%s/%s/%s", shaderFolder, rendererPath, vertFilename );
+    snprintf( fragFullPath, MAX_PATH, "%s/%s/%s", shaderFolder, rendererPath, fragFilename );
 
     m_VertShaderString = LoadCompleteFile( vertFullPath, &m_VertShaderStringLength );
     m_FragShaderString = LoadCompleteFile( fragFullPath, &m_FragShaderStringLength );
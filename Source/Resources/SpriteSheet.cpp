@@ -13,6 +13,8 @@
 #include "nlohmann-json/single_include/nlohmann/json.hpp"
 
 #include "SpriteSheet.h"
+#include "Utility/AllocationTracker.h"
+#include "Utility/Profiler.h"
 #include "Utility/Utility.h"
 
 namespace fw {
@@ -21,6 +23,9 @@ SpriteSheet::SpriteSheet(const char* name, const char* filename, Texture* pTextu
     : Resource( name )
     , m_pTexture( pTexture )
 {
+    FW_PROFILE_SCOPE( "SpriteSheet::Load" );
+    FW_ALLOC_TAG( AllocationTag::Resources );
+
     const char* jsonString = fw::LoadCompleteFile( filename, nullptr );
     nlohmann::json jSpriteSheet = nlohmann::json::parse( jsonString );
     delete[] jsonString;
@@ -28,7 +33,12 @@ SpriteSheet::SpriteSheet(const char* name, const char* filename, Texture* pTextu
     int sheetWidth = jSpriteSheet["Width"];
     int sheetHeight = jSpriteSheet["Height"];
 
+    // Names are only needed while loading, later sprites with the same name replace earlier ones.
+    std::vector<std::string> spriteNames;
+    std::unordered_map<std::string, SpriteID> spriteIDs;
+
     nlohmann::json& jSpriteArray = jSpriteSheet["Sprites"];
+    assert( jSpriteArray.size() < c_InvalidSpriteID );
     for( int i=0; i<jSpriteArray.size(); i++ )
     {
         nlohmann::json& jSprite = jSpriteArray[i];
@@ -39,8 +49,59 @@ SpriteSheet::SpriteSheet(const char* name, const char* filename, Texture* pTextu
         float h = jSprite["H"] - 1.0f;
         
         std::string name = jSprite["Name"];
+        SpriteInfo info = { vec2(w/sheetWidth, h/sheetHeight), vec2(x/sheetWidth, y/sheetHeight) };
 
-        m_Sprites[name.c_str()] = { vec2(w/sheetWidth, h/sheetHeight), vec2(x/sheetWidth, y/sheetHeight) };
+        auto it = spriteIDs.find( name );
+        if( it != spriteIDs.end() )
+        {
+            m_Sprites[it->second] = info;
+            continue;
+        }
+
+        spriteIDs[name] = (SpriteID)m_Sprites.size();
+        spriteNames.push_back( name );
+        m_Sprites.push_back( info );
+    }
+    m_SpriteNames.Build( spriteNames );
+
+    if( jSpriteSheet.contains( "Clips" ) )
+    {
+        std::vector<std::string> clipNames;
+
+        for( nlohmann::json& jClip : jSpriteSheet["Clips"] )
+        {
+            std::string clipName = jClip["Name"];
+            if( std::find( clipNames.begin(), clipNames.end(), clipName ) != clipNames.end() )
+            {
+                OutputMessage( "SpriteSheet %s: Duplicate clip %s.\n", name, clipName.c_str() );
+                continue;
+            }
+
+            AnimationClip clip;
+            clip.firstFrame = (uint32)m_ClipFrames.size();
+            clip.numFrames = 0;
+            clip.frameDuration = jClip.value( "FrameDuration", 0.1f );
+            clip.loop = jClip.value( "Loop", true );
+
+            for( nlohmann::json& jFrame : jClip["Frames"] )
+            {
+                std::string frameName = jFrame;
+                SpriteID id = GetSpriteID( frameName.c_str() );
+                if( id == c_InvalidSpriteID )
+                {
+                    OutputMessage( "SpriteSheet %s: Clip %s uses missing sprite %s.\n", name, clipName.c_str(), frameName.c_str() );
+                    continue;
+                }
+
+                m_ClipFrames.push_back( id );
+                clip.numFrames++;
+            }
+
+            clipNames.push_back( clipName );
+            m_Clips.push_back( clip );
+        }
+
+        m_ClipNames.Build( clipNames );
     }
 }
 
@@ -48,14 +109,44 @@ SpriteSheet::~SpriteSheet()
 {
 }
 
-SpriteSheet::SpriteInfo SpriteSheet::GetSpriteByName(std::string name)
+SpriteSheet::SpriteID SpriteSheet::GetSpriteID(const char* name) const
 {
-	if( m_Sprites.find( name ) != m_Sprites.end() )
-	{
-		return m_Sprites.at( name );
-	}
+    int32 index = m_SpriteNames.Find( name );
+    return index < 0 ? c_InvalidSpriteID : (SpriteID)index;
+}
 
-	return { vec2(1,1), vec2(0,0) };
+SpriteSheet::SpriteInfo SpriteSheet::GetSpriteByName(const char* name) const
+{
+    SpriteID id = GetSpriteID( name );
+    if( id != c_InvalidSpriteID )
+    {
+        return m_Sprites[id];
+    }
+
+    return { vec2(1,1), vec2(0,0) };
+}
+
+SpriteSheet::ClipID SpriteSheet::GetClipID(const char* name) const
+{
+    int32 index = m_ClipNames.Find( name );
+    return index < 0 ? c_InvalidClipID : (ClipID)index;
+}
+
+SpriteSheet::SpriteID SpriteSheet::GetClipFrame(ClipID id, float time) const
+{
+    const AnimationClip& clip = GetClip( id );
+    if( clip.numFrames == 0 )
+        return c_InvalidSpriteID;
+
+    if( clip.frameDuration <= 0 )
+        return m_ClipFrames[clip.firstFrame];
+
+    if( clip.loop )
+        time = fmodf( time, clip.frameDuration * clip.numFrames );
+
+    uint32 frame = (uint32)std::clamp( time / clip.frameDuration, 0.0f, (float)(clip.numFrames - 1) );
+
+    return m_ClipFrames[clip.firstFrame + frame];
 }
 
 void SpriteSheet::Editor_DisplayProperties()
@@ -63,7 +154,12 @@ void SpriteSheet::Editor_DisplayProperties()
     ImGui::Text( "SpriteSheet: %s", m_Name );
     ImGui::Separator();
 
-    ImGui::Text( "Sprites: %d", m_Sprites.size() );
+    ImGui::Text( "Sprites: %d", GetNumSprites() );
+    ImGui::Text( "Clips: %d", GetNumClips() );
+    for( ClipID i=0; i<m_Clips.size(); i++ )
+    {
+        ImGui::BulletText( "%s: %d frames", m_ClipNames.GetKey( i ).c_str(), m_Clips[i].numFrames );
+    }
 }
 
 } // namespace fw
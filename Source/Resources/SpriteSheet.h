@@ -11,14 +11,23 @@
 
 #include "Math/Vector.h"
 #include "Resources/Resource.h"
+#include "Utility/PerfectHash.h"
 
 namespace fw {
 
 class Texture;
 
+// Sprites are stored in a flat array, names are resolved to IDs once and the IDs used from then on.
+// Animation clips are runs of sprite IDs with a frame duration, loaded from the optional "Clips" array:
+//    "Clips": [ { "Name": "Walk", "Frames": [ "Walk0", "Walk1" ], "FrameDuration": 0.1, "Loop": true } ]
 class SpriteSheet : public Resource
 {
 public:
+    using SpriteID = uint16;
+    using ClipID = uint16;
+    static const SpriteID c_InvalidSpriteID = 0xFFFF;
+    static const ClipID c_InvalidClipID = 0xFFFF;
+
     struct SpriteInfo
     {
         // Needs to stay 4 contiguous floats to pass to shader as a vec4.
@@ -28,20 +37,51 @@ public:
         vec4& asVec4() { return *(vec4*)&uvScale.x; }
     };
 
+    struct AnimationClip
+    {
+        uint32 firstFrame; // Index into the sheet's clip frames.
+        uint32 numFrames;
+        float frameDuration; // In seconds.
+        bool loop;
+    };
+
 public:
     SpriteSheet(const char* name, const char* filename, Texture* pTexture);
     virtual ~SpriteSheet();
 
+    // Sprites.
+    // Returns c_InvalidSpriteID if the name isn't found.
+    SpriteID GetSpriteID(const char* name) const;
+    const SpriteInfo& GetSprite(SpriteID id) const { assert( id < m_Sprites.size() ); return m_Sprites[id]; }
+    const char* GetSpriteName(SpriteID id) const { return m_SpriteNames.GetKey( id ).c_str(); }
+    uint32 GetNumSprites() const { return (uint32)m_Sprites.size(); }
+    // Slower than looking up an ID once and using GetSprite, returns the whole texture if the name isn't found.
+    SpriteInfo GetSpriteByName(const char* name) const;
+    SpriteInfo GetSpriteByName(const std::string& name) const { return GetSpriteByName( name.c_str() ); }
+
+    // Animation clips.
+    // Returns c_InvalidClipID if the name isn't found.
+    ClipID GetClipID(const char* name) const;
+    const AnimationClip& GetClip(ClipID id) const { assert( id < m_Clips.size() ); return m_Clips[id]; }
+    uint32 GetNumClips() const { return (uint32)m_Clips.size(); }
+    // Frame to show at a time in seconds since the clip started, non-looping clips hold their last frame.
+    SpriteID GetClipFrame(ClipID id, float time) const;
+
     // Getters.
     Texture* GetTexture() { return m_pTexture; }
-    SpriteInfo GetSpriteByName(std::string name);    
 
     // Editor.
     virtual void Editor_DisplayProperties() override;
     
 protected:
     fw::Texture* m_pTexture = nullptr;
-    std::map<std::string, SpriteInfo> m_Sprites;
+
+    std::vector<SpriteInfo> m_Sprites;
+    PerfectHashTable m_SpriteNames;
+
+    std::vector<AnimationClip> m_Clips;
+    std::vector<SpriteID> m_ClipFrames;
+    PerfectHashTable m_ClipNames;
 };
 
 } // namespace fw
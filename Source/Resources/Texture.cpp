@@ -20,6 +20,8 @@
 #include "Mesh.h"
 #include "ShaderProgram.h"
 #include "Math/Matrix.h"
+#include "Utility/AllocationTracker.h"
+#include "Utility/Profiler.h"
 #include "Utility/Utility.h"
 #include "Texture.h"
 
@@ -33,6 +35,9 @@ Texture::Texture(const char* name)
 Texture::Texture(const char* name, const char* filename)
     : Resource( name )
 {
+    FW_PROFILE_SCOPE( "Texture::Load" );
+    FW_ALLOC_TAG( AllocationTag::Resources );
+
     // Load the file contents.
     uint32 length;
     char* fileContents = LoadCompleteFile( filename, &length );
@@ -13,13 +13,16 @@
 #include "Scene.h"
 #include "Components/ComponentManager.h"
 #include "Components/CoreComponents.h"
-#include "Components/CoreSystems.h"
 #include "Editor/EditorCore.h"
 #include "EventSystem/Events.h"
 #include "EventSystem/EventManager.h"
+#include "Math/Frustum.h"
 #include "Math/Matrix.h"
 #include "Objects/GameObject.h"
 #include "Resources/Mesh.h"
+#include "Utility/AllocationTracker.h"
+#include "Utility/Profiler.h"
+#include "Utility/Utility.h"
 
 namespace fw {
 
@@ -27,13 +30,15 @@ Scene::Scene(GameCore* pGameCore)
     : m_pGameCore( pGameCore )
 {
     m_pComponentManager = m_pGameCore->CreateComponentManager();
+    m_pComponentManager->SetNumThreads( m_pGameCore->GetFramework()->GetNumWorkerThreads() );
 }
 
 Scene::~Scene()
 {
-    for( GameObject* pObject : m_Objects )
+    // Destroys any remaining objects.
+    for( ObjectPoolBase<GameObject>* pPool : m_ObjectPools )
     {
-        delete pObject;
+        delete pPool;
     }
 
     delete m_pComponentManager;
@@ -56,21 +61,33 @@ void Scene::OnEvent(Event* pEvent)
     if( pEvent->GetType() == RemoveFromGameEvent::GetStaticEventType() )
     {
         RemoveFromGameEvent* pRemoveFromGameEvent = static_cast<RemoveFromGameEvent*>( pEvent );
-        GameObject* pObject = pRemoveFromGameEvent->GetGameObject();
+        if( pRemoveFromGameEvent->GetScene() != this )
+            return;
 
-        auto it = std::find( m_Objects.begin(), m_Objects.end(), pObject );
-        m_Objects.erase( it );
+        GameObject* pObject = GetGameObject( pRemoveFromGameEvent->GetHandle() );
+        if( pObject == nullptr )
+        {
+            OutputMessage( "RemoveFromGameEvent: GameObject was already removed.\n" );
+            return;
+        }
 
-        delete pObject;
+        DestroyGameObject( pObject );
     }
 }
 
 void Scene::Update(float deltaTime)
 {
-    for( GameObject* pObject : m_Objects )
+    FW_PROFILE_SCOPE( "Scene::Update" );
+    FW_ALLOC_TAG( AllocationTag::Scene );
+
+    // By index, since objects can be created or destroyed during Update.
+    for( size_t i=0; i<m_UpdatableObjects.size(); i++ )
     {
-        pObject->Update( deltaTime );
+        m_UpdatableObjects[i]->Update( deltaTime );
     }
+
+    // Run flecs systems in the update phases, OnUpdate etc.
+    m_pComponentManager->RunUpdatePhases( deltaTime );
 }
 
 void Scene::Draw(int viewID)
@@ -78,20 +95,74 @@ void Scene::Draw(int viewID)
     DrawIntoView( viewID );
 }
 
+void Scene::Prepare()
+{
+    FW_PROFILE_SCOPE( "Scene::Prepare" );
+    FW_ALLOC_TAG( AllocationTag::Renderer );
+
+    FWCore* pFramework = m_pGameCore->GetFramework();
+    m_PreparedFrame = pFramework->GetFrameCount();
+
+    // Transforms and the draw list are built in PreStore, once no matter how many views are drawn.
+    m_pComponentManager->RunPreparePhases();
+
+    pFramework->GetFrameStats()->SetValue( FrameStat::DrawListItems, (float)m_pComponentManager->GetDrawList().size() );
+}
+
 void Scene::DrawIntoView(int viewID)
 {
-    Uniforms* pUniforms = m_pGameCore->GetUniforms();
+    FW_PROFILE_SCOPE( "Scene::DrawIntoView" );
+    FW_ALLOC_TAG( AllocationTag::Renderer );
+
+    FWCore* pFramework = m_pGameCore->GetFramework();
+    if( m_PreparedFrame != pFramework->GetFrameCount() )
+    {
+        Prepare();
+    }
 
-    System_UpdateAllTransforms( m_pComponentManager );
-    System_DrawAllMeshes( m_pComponentManager, viewID, pUniforms );
+    ComponentManager::RenderContext context;
+    context.viewID = viewID;
+    context.pUniforms = m_pGameCore->GetUniforms();
+
+    // Views without a camera transform this frame aren't culled.
+    Frustum frustum;
+    const mat4* pViewProj = pFramework->GetViewProjection( viewID );
+    if( pViewProj )
+    {
+        frustum.Set( *pViewProj );
+        context.pFrustum = &frustum;
+        context.pViewProj = pViewProj;
+    }
+
+    context.frameNumber = pFramework->GetFrameCount();
+    context.time = (float)GetSystemTimeSinceGameStart();
+    context.lodFadeDuration = pFramework->GetLODFadeDuration();
+
+    // With pipelined rendering, the draws are recorded to be submitted on the render thread next frame.
+    // Otherwise they can be split across the task scheduler's threads.
+    context.pSnapshot = pFramework->GetRenderSnapshot();
+    if( context.pSnapshot == nullptr && pFramework->IsParallelSubmissionEnabled() )
+    {
+        context.pTaskScheduler = pFramework->GetTaskScheduler();
+    }
+
+    // Meshes are culled and submitted, then anything else in OnStore runs.
+    uint32 numCulled = m_pComponentManager->RunStorePhases( context );
+
+    pFramework->GetFrameStats()->AddValue( FrameStat::CulledDrawItems, (float)numCulled );
 }
 
 void Scene::SaveToJSON(nlohmann::json& jScene)
 {
+    FW_PROFILE_SCOPE( "Scene::SaveToJSON" );
+
     nlohmann::json jGameObjectArray = nlohmann::json::array();
 
     for( GameObject* pObject : m_Objects )
     {
+        if( pObject == nullptr )
+            continue;
+
         nlohmann::json jGameObject;
         pObject->SaveToJSON( jGameObject );
         jGameObjectArray.push_back( jGameObject );
@@ -101,16 +172,82 @@ void Scene::SaveToJSON(nlohmann::json& jScene)
 
 void Scene::LoadFromJSON(nlohmann::json& jScene)
 {
+    FW_PROFILE_SCOPE( "Scene::LoadFromJSON" );
+
     nlohmann::json jGameObjectArray = jScene["Objects"];
 
     for( nlohmann::json jGameObject : jGameObjectArray )
     {
-        GameObject* pObject = new GameObject( this );
+        GameObject* pObject = CreateGameObject();
         pObject->LoadFromJSON( jGameObject );
-        m_Objects.push_back( pObject );
     }
 }
 
+void Scene::DestroyGameObject(GameObject* pObject)
+{
+    assert( pObject->GetScene() == this );
+    assert( pObject->GetHandle().IsNull() == false ); // Not created with CreateGameObject.
+
+    assert( m_Objects[pObject->m_SceneIndex] == pObject );
+
+    SetUpdatable( pObject, false );
+
+    m_Objects[pObject->m_SceneIndex] = nullptr;
+    m_NumDestroyedObjects++;
+    if( m_NumDestroyedObjects > m_Objects.size() / 2 )
+    {
+        CompactGameObjects();
+    }
+
+    GameObjectHandle handle = pObject->GetHandle();
+    m_ObjectPools[handle.poolIndex]->Destroy( handle.handle );
+}
+
+void Scene::CompactGameObjects()
+{
+    uint32 count = 0;
+    for( GameObject* pObject : m_Objects )
+    {
+        if( pObject )
+        {
+            pObject->m_SceneIndex = count;
+            m_Objects[count++] = pObject;
+        }
+    }
+
+    m_Objects.resize( count );
+    m_NumDestroyedObjects = 0;
+}
+
+void Scene::SetUpdatable(GameObject* pObject, bool updatable)
+{
+    assert( pObject->GetHandle().IsNull() == false ); // Not created with CreateGameObject.
+
+    uint32 index = pObject->m_UpdatableIndex;
+    if( updatable && index == GameObject::c_NotListed )
+    {
+        pObject->m_UpdatableIndex = (uint32)m_UpdatableObjects.size();
+        m_UpdatableObjects.push_back( pObject );
+    }
+    else if( updatable == false && index != GameObject::c_NotListed )
+    {
+        // Move the last object into the gap.
+        GameObject* pLast = m_UpdatableObjects.back();
+        m_UpdatableObjects[index] = pLast;
+        pLast->m_UpdatableIndex = index;
+        m_UpdatableObjects.pop_back();
+        pObject->m_UpdatableIndex = GameObject::c_NotListed;
+    }
+}
+
+GameObject* Scene::GetGameObject(GameObjectHandle handle)
+{
+    if( handle.IsNull() || handle.poolIndex >= m_ObjectPools.size() )
+        return nullptr;
+
+    return m_ObjectPools[handle.poolIndex]->GetBase( handle.handle );
+}
+
 flecs::world& Scene::GetFlecsWorld()
 {
     return m_pComponentManager->GetFlecsWorld();
@@ -126,26 +263,25 @@ void Scene::Editor_DisplayObjectList()
     EditorCore* pEditorCore = dynamic_cast<EditorCore*>( m_pGameCore );
     if( pEditorCore )
     {
-        std::string name = m_Name;
-        if( m_Name.length() == 0 )
-        {
-            name = "untitled scene";
-        }
+        const char* sceneName = m_Name.empty() ? "untitled scene" : m_Name.c_str();
 
-        if( ImGui::TreeNodeEx( name.c_str(), ImGuiTreeNodeFlags_DefaultOpen ) )
+        if( ImGui::TreeNodeEx( sceneName, ImGuiTreeNodeFlags_DefaultOpen ) )
         {
             // Context menu for Scene.
             if( ImGui::BeginPopupContextItem() )
             {
                 if( ImGui::MenuItem( "Add GameObject" ) )
                 {
-                    m_Objects.push_back( new GameObject( this, "New Object", fw::vec3(0,0,0), nullptr, nullptr ) );
+                    CreateGameObject( "New Object", fw::vec3(0,0,0), nullptr, nullptr );
                 }
                 ImGui::EndPopup();
             }
 
             for( GameObject* pGameObject : m_Objects )
             {
+                if( pGameObject == nullptr )
+                    continue;
+
                 const char* name = "No Name";
         
                 bool hasName = pGameObject->GetEntity().has<NameData>();
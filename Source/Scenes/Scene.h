@@ -9,14 +9,18 @@
 
 #pragma once
 
+#include <type_traits>
+#include <typeindex>
+
 #include "../Libraries/nlohmann-json/single_include/nlohmann/json_fwd.hpp"
+#include "Objects/GameObject.h"
+#include "Utility/ObjectPool.h"
 
 namespace fw {
 
 class ComponentManager;
 class Event;
 class GameCore;
-class GameObject;
 
 class Scene
 {
@@ -32,11 +36,27 @@ public:
     virtual void Update(float deltaTime);
     virtual void Draw(int viewID);
 
+    // Updates transforms and builds the draw list, DrawIntoView calls this on the first view drawn each frame.
+    // Call it directly if transforms are needed earlier, or after changing objects between views.
+    void Prepare();
+    // Culls the prepared draw list against the view's frustum, set by Camera::Enable, then submits it.
     void DrawIntoView(int viewID);
 
     // Getters.
     GameCore* GetGameCore() { return m_pGameCore; }
     virtual Camera* GetCamera() { return nullptr; }
+    uint32 GetNumGameObjects() { return (uint32)m_Objects.size() - m_NumDestroyedObjects; }
+
+    // GameObjects.
+    // Objects are constructed in a pool per type with the scene as the first constructor argument.
+    template<typename T = GameObject, typename... Args> T* CreateGameObject(Args&&... args);
+    void DestroyGameObject(GameObject* pObject);
+    // Only updatable objects have GameObject::Update called, CreateGameObject sets this for types that override Update.
+    void SetUpdatable(GameObject* pObject, bool updatable);
+    // Returns nullptr if the object was destroyed.
+    GameObject* GetGameObject(GameObjectHandle handle);
+    // Avoids regrowing the object list when creating many objects at once.
+    void ReserveGameObjects(uint32 count) { m_Objects.reserve( count ); }
 
     // Setters.
     void SetName(std::string name) { m_Name = name; }
@@ -62,12 +82,58 @@ protected:
 
     // ECS.
     ComponentManager* m_pComponentManager = nullptr;
+    uint32 m_PreparedFrame = 0xFFFFFFFF;
 
-    // GameObjects.
-    std::vector<GameObject*> m_Objects;
+    // GameObjects, in creation order. Destroyed objects leave nullptrs behind until the list is compacted.
+    const std::vector<GameObject*>& GetGameObjects() { return m_Objects; }
 
     // Editor.
     std::string m_Editor_Filename;
+
+private:
+    // GameObjects.
+    // Only CreateGameObject adds to these, objects that don't come from a pool can't be updated or destroyed.
+    // m_Objects keeps creation order for the editor and saving, the pools own the memory.
+    // Destroying an object nulls its entry, they're compacted once more than half are null.
+    // m_UpdatableObjects has no set order, objects are swapped into the gaps removals leave.
+    void CompactGameObjects();
+    std::vector<GameObject*> m_Objects;
+    uint32 m_NumDestroyedObjects = 0;
+    std::vector<ObjectPoolBase<GameObject>*> m_ObjectPools;
+    std::unordered_map<std::type_index, uint32> m_ObjectPoolIndices;
+    std::vector<GameObject*> m_UpdatableObjects;
 };
 
+template<typename T, typename... Args> T* Scene::CreateGameObject(Args&&... args)
+{
+    uint32 poolIndex;
+    auto it = m_ObjectPoolIndices.find( typeid(T) );
+    if( it == m_ObjectPoolIndices.end() )
+    {
+        poolIndex = (uint32)m_ObjectPools.size();
+        m_ObjectPools.push_back( new ObjectPool<T, GameObject>() );
+        m_ObjectPoolIndices[typeid(T)] = poolIndex;
+    }
+    else
+    {
+        poolIndex = it->second;
+    }
+
+    ObjectPool<T, GameObject>* pPool = static_cast<ObjectPool<T, GameObject>*>( m_ObjectPools[poolIndex] );
+    PoolHandle handle = pPool->Create( this, std::forward<Args>( args )... );
+
+    T* pObject = pPool->Get( handle );
+    pObject->m_Handle = { poolIndex, handle };
+    pObject->m_SceneIndex = (uint32)m_Objects.size();
+    m_Objects.push_back( pObject );
+
+    // Skip the virtual call for types that don't have any update logic.
+    if constexpr( std::is_same_v<decltype(&T::Update), void (GameObject::*)(float)> == false )
+    {
+        SetUpdatable( pObject, true );
+    }
+
+    return pObject;
+}
+
 } // namespace fw
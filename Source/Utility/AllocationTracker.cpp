@@ -0,0 +1,277 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "CoreHeaders.h"
+
+#include <atomic>
+#include <new>
+
+#include "AllocationTracker.h"
+
+namespace fw {
+namespace AllocationTracker {
+
+static const char* AllocationTagNames[] =
+{
+    "Untagged",
+    "Core",
+    "Scene",
+    "ECS",
+    "Renderer",
+    "Resources",
+    "Events",
+    "Editor",
+    "Game",
+};
+static_assert( sizeof(AllocationTagNames)/sizeof(AllocationTagNames[0]) == (int)AllocationTag::Count );
+
+struct AtomicCounts
+{
+    std::atomic<uint64> numAllocations = 0;
+    std::atomic<uint64> numBytes = 0;
+    std::atomic<uint64> numFrees = 0;
+
+    Counts Load() const { return { numAllocations.load(), numBytes.load(), numFrees.load() }; }
+};
+
+// Running totals. Frees can't be attributed to a tag, so they're only counted in g_Totals.
+static AtomicCounts g_Totals;
+static AtomicCounts g_TagTotals[(int)AllocationTag::Count];
+
+// Totals at the end of the previous frame and the difference over the last frame.
+static Counts g_FrameStartTotals;
+static Counts g_FrameStartTagTotals[(int)AllocationTag::Count];
+static Counts g_LastFrame;
+static Counts g_LastFrameTags[(int)AllocationTag::Count];
+
+static thread_local AllocationTag t_CurrentTag = AllocationTag::Untagged;
+static thread_local uint32 t_NoAllocationDepth = 0;
+
+static Counts Subtract(const Counts& a, const Counts& b)
+{
+    return { a.numAllocations - b.numAllocations, a.numBytes - b.numBytes, a.numFrees - b.numFrees };
+}
+
+static void RecordAllocation(size_t size)
+{
+    assert( t_NoAllocationDepth == 0 ); // Allocation inside a FW_ASSERT_NO_ALLOCATIONS scope.
+
+    g_Totals.numAllocations.fetch_add( 1, std::memory_order_relaxed );
+    g_Totals.numBytes.fetch_add( size, std::memory_order_relaxed );
+
+    AtomicCounts& tagCounts = g_TagTotals[(int)t_CurrentTag];
+    tagCounts.numAllocations.fetch_add( 1, std::memory_order_relaxed );
+    tagCounts.numBytes.fetch_add( size, std::memory_order_relaxed );
+}
+
+static void RecordFree()
+{
+    g_Totals.numFrees.fetch_add( 1, std::memory_order_relaxed );
+}
+
+bool IsEnabled()
+{
+    return FW_ALLOCATION_TRACKING;
+}
+
+Counts GetTotals()
+{
+    return g_Totals.Load();
+}
+
+Counts GetTotals(AllocationTag tag)
+{
+    return g_TagTotals[(int)tag].Load();
+}
+
+void MarkFrame()
+{
+    Counts totals = g_Totals.Load();
+    g_LastFrame = Subtract( totals, g_FrameStartTotals );
+    g_FrameStartTotals = totals;
+
+    for( int i=0; i<(int)AllocationTag::Count; i++ )
+    {
+        Counts tagTotals = g_TagTotals[i].Load();
+        g_LastFrameTags[i] = Subtract( tagTotals, g_FrameStartTagTotals[i] );
+        g_FrameStartTagTotals[i] = tagTotals;
+    }
+}
+
+Counts GetLastFrame()
+{
+    return g_LastFrame;
+}
+
+Counts GetLastFrame(AllocationTag tag)
+{
+    return g_LastFrameTags[(int)tag];
+}
+
+const char* GetTagName(AllocationTag tag)
+{
+    return AllocationTagNames[(int)tag];
+}
+
+void Editor_DisplayTags()
+{
+    if( IsEnabled() == false )
+    {
+        ImGui::Text( "Allocation tracking is disabled, see FW_ALLOCATION_TRACKING." );
+        return;
+    }
+
+    if( ImGui::BeginTable( "Allocations", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit ) )
+    {
+        ImGui::TableSetupColumn( "Tag" );
+        ImGui::TableSetupColumn( "Allocs/Frame" );
+        ImGui::TableSetupColumn( "KB/Frame" );
+        ImGui::TableSetupColumn( "Total Allocs" );
+        ImGui::TableHeadersRow();
+
+        for( int i=0; i<(int)AllocationTag::Count; i++ )
+        {
+            Counts lastFrame = g_LastFrameTags[i];
+            Counts totals = g_TagTotals[i].Load();
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::Text( "%s", AllocationTagNames[i] );
+            ImGui::TableNextColumn(); ImGui::Text( "%llu", (unsigned long long)lastFrame.numAllocations );
+            ImGui::TableNextColumn(); ImGui::Text( "%0.2f", lastFrame.numBytes / 1024.0f );
+            ImGui::TableNextColumn(); ImGui::Text( "%llu", (unsigned long long)totals.numAllocations );
+        }
+
+        ImGui::EndTable();
+    }
+
+    Counts totals = g_Totals.Load();
+    ImGui::Text( "Live allocations: %llu", (unsigned long long)(totals.numAllocations - totals.numFrees) );
+}
+
+TagScope::TagScope(AllocationTag tag)
+    : m_PreviousTag( t_CurrentTag )
+{
+    t_CurrentTag = tag;
+}
+
+TagScope::~TagScope()
+{
+    t_CurrentTag = m_PreviousTag;
+}
+
+NoAllocationScope::NoAllocationScope()
+{
+    t_NoAllocationDepth++;
+}
+
+NoAllocationScope::~NoAllocationScope()
+{
+    t_NoAllocationDepth--;
+}
+
+} // namespace AllocationTracker
+} // namespace fw
+
+#if FW_ALLOCATION_TRACKING
+
+// Global replacements, the nothrow versions forward to these by default and rely on them throwing on failure.
+
+void* operator new(size_t size)
+{
+    void* ptr = malloc( size ? size : 1 );
+    if( ptr == nullptr )
+        throw std::bad_alloc();
+
+    fw::AllocationTracker::RecordAllocation( size );
+
+    return ptr;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new( size );
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if( ptr == nullptr )
+        return;
+
+    fw::AllocationTracker::RecordFree();
+    free( ptr );
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    operator delete( ptr );
+}
+
+void operator delete(void* ptr, size_t size) noexcept
+{
+    operator delete( ptr );
+}
+
+void operator delete[](void* ptr, size_t size) noexcept
+{
+    operator delete( ptr );
+}
+
+// Over-aligned versions, used for types with alignas greater than the default new alignment.
+// Windows needs a matching _aligned_free, so these can't share malloc and free with the ones above.
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+#if FW_PLATFORM_WINDOWS
+    void* ptr = _aligned_malloc( size ? size : 1, (size_t)alignment );
+#else
+    void* ptr = nullptr;
+    if( posix_memalign( &ptr, (size_t)alignment, size ? size : 1 ) != 0 )
+        ptr = nullptr;
+#endif
+    if( ptr == nullptr )
+        throw std::bad_alloc();
+
+    fw::AllocationTracker::RecordAllocation( size );
+    return ptr;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return operator new( size, alignment );
+}
+
+void operator delete(void* ptr, std::align_val_t alignment) noexcept
+{
+    if( ptr == nullptr )
+        return;
+
+    fw::AllocationTracker::RecordFree();
+#if FW_PLATFORM_WINDOWS
+    _aligned_free( ptr );
+#else
+    free( ptr );
+#endif
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept
+{
+    operator delete( ptr, alignment );
+}
+
+void operator delete(void* ptr, size_t size, std::align_val_t alignment) noexcept
+{
+    operator delete( ptr, alignment );
+}
+
+void operator delete[](void* ptr, size_t size, std::align_val_t alignment) noexcept
+{
+    operator delete( ptr, alignment );
+}
+
+#endif // FW_ALLOCATION_TRACKING
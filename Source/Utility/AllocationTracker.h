@@ -0,0 +1,101 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#pragma once
+
+// Allocation tracking.
+// When FW_ALLOCATION_TRACKING is enabled, global operator new/delete are replaced to count
+//   allocations and bytes, both in total and per tag.
+// Allocations are tagged with whatever FW_ALLOC_TAG scope is active on the allocating thread.
+// FW_ASSERT_NO_ALLOCATIONS asserts if anything allocates through operator new before the scope ends.
+// Allocations made directly with malloc, like flecs' internal storage, aren't seen.
+//
+// Usage:
+//    {
+//        FW_ALLOC_TAG( AllocationTag::Resources );
+//        ...
+//    }
+//
+// Enabled with the FW_ALLOCATION_TRACKING cmake option, which is off by default since every allocation pays for the counting.
+
+#ifndef FW_ALLOCATION_TRACKING
+#define FW_ALLOCATION_TRACKING 0
+#endif
+
+#define FW_ALLOC_CONCAT_INNER(a, b) a##b
+#define FW_ALLOC_CONCAT(a, b) FW_ALLOC_CONCAT_INNER(a, b)
+
+#if FW_ALLOCATION_TRACKING
+#define FW_ALLOC_TAG(tag) fw::AllocationTracker::TagScope FW_ALLOC_CONCAT(fwAllocTag_, __LINE__)( fw::tag )
+#define FW_ASSERT_NO_ALLOCATIONS() fw::AllocationTracker::NoAllocationScope FW_ALLOC_CONCAT(fwNoAllocations_, __LINE__)
+#else
+#define FW_ALLOC_TAG(tag)
+#define FW_ASSERT_NO_ALLOCATIONS()
+#endif
+
+namespace fw {
+
+enum class AllocationTag
+{
+    Untagged,
+    Core,
+    Scene,
+    ECS,
+    Renderer,
+    Resources,
+    Events,
+    Editor,
+    Game,
+    Count,
+};
+
+namespace AllocationTracker {
+
+struct Counts
+{
+    uint64 numAllocations = 0;
+    uint64 numBytes = 0;
+    uint64 numFrees = 0;
+};
+
+bool IsEnabled();
+
+// Running totals since startup.
+Counts GetTotals();
+Counts GetTotals(AllocationTag tag);
+
+// Counts for the last completed frame.
+void MarkFrame(); // Called by FWCore at the end of each frame.
+Counts GetLastFrame();
+Counts GetLastFrame(AllocationTag tag);
+
+const char* GetTagName(AllocationTag tag);
+
+// Editor.
+void Editor_DisplayTags();
+
+class TagScope
+{
+public:
+    TagScope(AllocationTag tag);
+    ~TagScope();
+
+protected:
+    AllocationTag m_PreviousTag;
+};
+
+class NoAllocationScope
+{
+public:
+    NoAllocationScope();
+    ~NoAllocationScope();
+};
+
+} // namespace AllocationTracker
+} // namespace fw
@@ -0,0 +1,85 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "CoreHeaders.h"
+
+#include "FrameArena.h"
+
+namespace fw {
+
+FrameArena::FrameArena(size_t bytesPerFrame)
+    : m_BytesPerFrame( bytesPerFrame )
+{
+    for( Buffer& buffer : m_Buffers )
+    {
+        buffer.pMemory = new uint8[bytesPerFrame];
+    }
+}
+
+FrameArena::~FrameArena()
+{
+    for( Buffer& buffer : m_Buffers )
+    {
+        ResetBuffer( buffer );
+        delete[] buffer.pMemory;
+    }
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+    assert( alignment != 0 && (alignment & (alignment-1)) == 0 );
+
+    Buffer& buffer = m_Buffers[m_CurrentBuffer];
+
+    // Bump the offset, retrying if another thread got there first.
+    size_t offset = buffer.offset.load( std::memory_order_relaxed );
+    while( true )
+    {
+        uintptr_t address = (uintptr_t)buffer.pMemory + offset;
+        size_t padding = (alignment - (address & (alignment-1))) & (alignment-1);
+        size_t newOffset = offset + padding + size;
+
+        if( newOffset > m_BytesPerFrame )
+            break;
+
+        if( buffer.offset.compare_exchange_weak( offset, newOffset, std::memory_order_relaxed ) )
+            return buffer.pMemory + offset + padding;
+    }
+
+    // Out of space, fall back to the heap until the buffer resets.
+    // operator new is aligned for anything up to max_align_t.
+    assert( alignment <= alignof(std::max_align_t) );
+    void* ptr = new uint8[size];
+
+    std::lock_guard<std::mutex> lock( buffer.overflowMutex );
+    buffer.overflowAllocations.push_back( ptr );
+    buffer.overflowBytes += size;
+
+    return ptr;
+}
+
+void FrameArena::EndFrame()
+{
+    m_CurrentBuffer = 1 - m_CurrentBuffer;
+    ResetBuffer( m_Buffers[m_CurrentBuffer] );
+}
+
+void FrameArena::ResetBuffer(Buffer& buffer)
+{
+    for( void* ptr : buffer.overflowAllocations )
+    {
+        delete[] static_cast<uint8*>( ptr );
+    }
+    buffer.overflowAllocations.clear();
+    buffer.overflowBytes = 0;
+
+    buffer.offset = 0;
+}
+
+} // namespace fw
@@ -0,0 +1,88 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+namespace fw {
+
+// Double buffered bump allocator for per-frame temporaries.
+// Memory allocated during a frame stays valid until the end of the following frame,
+//   so data built during frame N can still be read by the render thread during frame N+1.
+// Nothing is freed individually, FWCore::Run calls EndFrame after bgfx::frame, which
+//   switches buffers and resets the one that's now two frames old.
+// Allocate is lock free and can be called from any thread, but not while EndFrame is running.
+// If a buffer runs out, allocations fall back to the heap and are freed with the buffer.
+class FrameArena
+{
+public:
+    static const size_t c_DefaultBytesPerFrame = 1024 * 1024;
+
+    FrameArena(size_t bytesPerFrame = c_DefaultBytesPerFrame);
+    virtual ~FrameArena();
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    template<typename T> T* AllocateArray(size_t count) { return static_cast<T*>( Allocate( sizeof(T) * count, alignof(T) ) ); }
+
+    void EndFrame();
+
+    // Getters.
+    size_t GetBytesPerFrame() { return m_BytesPerFrame; }
+    size_t GetBytesUsed() { return m_Buffers[m_CurrentBuffer].offset; }
+    size_t GetOverflowBytes() { return m_Buffers[m_CurrentBuffer].overflowBytes; }
+
+protected:
+    struct Buffer
+    {
+        uint8* pMemory = nullptr;
+        std::atomic<size_t> offset = 0;
+
+        // Heap allocations made after the buffer filled up.
+        std::mutex overflowMutex;
+        std::vector<void*> overflowAllocations;
+        size_t overflowBytes = 0;
+    };
+
+    void ResetBuffer(Buffer& buffer);
+
+protected:
+    size_t m_BytesPerFrame = 0;
+    Buffer m_Buffers[2];
+    int m_CurrentBuffer = 0;
+};
+
+// Allocator adapter so STL containers can live in a FrameArena.
+// deallocate does nothing, so containers must not be reused once their arena buffer resets,
+//   assign them a new empty container instead of calling clear().
+template<typename T> class FrameArenaAllocator
+{
+public:
+    using value_type = T;
+
+    FrameArenaAllocator(FrameArena* pArena) : m_pArena( pArena ) {}
+    template<typename U> FrameArenaAllocator(const FrameArenaAllocator<U>& other) : m_pArena( other.GetArena() ) {}
+
+    T* allocate(size_t count) { return m_pArena->AllocateArray<T>( count ); }
+    void deallocate(T* ptr, size_t count) {}
+
+    FrameArena* GetArena() const { return m_pArena; }
+
+    template<typename U> bool operator==(const FrameArenaAllocator<U>& other) const { return m_pArena == other.GetArena(); }
+    template<typename U> bool operator!=(const FrameArenaAllocator<U>& other) const { return m_pArena != other.GetArena(); }
+
+protected:
+    FrameArena* m_pArena;
+};
+
+template<typename T> using FrameVector = std::vector<T, FrameArenaAllocator<T>>;
+
+} // namespace fw
@@ -0,0 +1,281 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "CoreHeaders.h"
+
+#include "FrameStats.h"
+#include "Utility/AllocationTracker.h"
+#include "Utility/Utility.h"
+
+namespace fw {
+
+static const char* FrameStatNames[] =
+{
+    "Frame (ms)",
+    "StartFrame (ms)",
+    "Update (ms)",
+    "Draw (ms)",
+    "EndFrame (ms)",
+    "bgfx::frame (ms)",
+    "Frame Pacing (ms)",
+
+    "Draw Calls",
+    "Render Thread (ms)",
+    "GPU (ms)",
+    "Wait Render (ms)",
+    "Wait Submit (ms)",
+    "Texture Memory (MB)",
+    "Render Target Memory (MB)",
+
+    "GameObjects",
+    "Entities",
+    "Resources",
+    "Events Dispatched",
+    "Events Queued",
+
+    "Draw List Items",
+    "Culled Draw Items",
+
+    "Allocations",
+    "Allocated (KB)",
+
+    "Frame Arena (KB)",
+};
+static_assert( sizeof(FrameStatNames)/sizeof(FrameStatNames[0]) == (int)FrameStat::Count );
+
+// RollingHistogram.
+
+void RollingHistogram::AddSample(float value)
+{
+    m_Samples[m_NextIndex] = value;
+    m_NextIndex = (m_NextIndex + 1) % c_MaxSamples;
+    if( m_NumSamples < c_MaxSamples )
+        m_NumSamples++;
+}
+
+void RollingHistogram::Clear()
+{
+    m_NextIndex = 0;
+    m_NumSamples = 0;
+}
+
+float RollingHistogram::GetLatest() const
+{
+    if( m_NumSamples == 0 )
+        return 0;
+
+    return m_Samples[(m_NextIndex + c_MaxSamples - 1) % c_MaxSamples];
+}
+
+float RollingHistogram::GetAverage() const
+{
+    if( m_NumSamples == 0 )
+        return 0;
+
+    float total = 0;
+    for( uint32 i=0; i<m_NumSamples; i++ )
+        total += m_Samples[i];
+
+    return total / m_NumSamples;
+}
+
+float RollingHistogram::GetMax() const
+{
+    if( m_NumSamples == 0 )
+        return 0;
+
+    return *std::max_element( m_Samples, m_Samples + m_NumSamples );
+}
+
+// Percentile from 0 to 100.
+float RollingHistogram::GetPercentile(float percentile) const
+{
+    if( m_NumSamples == 0 )
+        return 0;
+
+    float sorted[c_MaxSamples];
+    std::copy( m_Samples, m_Samples + m_NumSamples, sorted );
+
+    uint32 index = (uint32)( percentile / 100.0f * (m_NumSamples - 1) + 0.5f );
+    index = std::min( index, m_NumSamples - 1 );
+    std::nth_element( sorted, sorted + index, sorted + m_NumSamples );
+
+    return sorted[index];
+}
+
+// FrameStats::Timer.
+
+FrameStats::Timer::Timer(FrameStats* pStats, FrameStat stat)
+    : m_pStats( pStats )
+    , m_Stat( stat )
+    , m_StartTime( GetSystemTime() )
+{
+}
+
+FrameStats::Timer::~Timer()
+{
+    m_pStats->AddValue( m_Stat, (float)( (GetSystemTime() - m_StartTime) * 1000.0 ) );
+}
+
+// FrameStats.
+
+FrameStats::FrameStats()
+{
+}
+
+FrameStats::~FrameStats()
+{
+    StopCSV();
+}
+
+void FrameStats::GatherBGFXStats()
+{
+    const bgfx::Stats* pStats = bgfx::getStats();
+
+    SetValue( FrameStat::DrawCalls, (float)pStats->numDraw );
+
+    double cpuToMS = 1000.0 / pStats->cpuTimerFreq;
+    SetValue( FrameStat::RenderThreadTime, (float)( (pStats->cpuTimeEnd - pStats->cpuTimeBegin) * cpuToMS ) );
+    SetValue( FrameStat::WaitRender, (float)( pStats->waitRender * cpuToMS ) );
+    SetValue( FrameStat::WaitSubmit, (float)( pStats->waitSubmit * cpuToMS ) );
+
+    // Not every renderer supports gpu timers.
+    if( pStats->gpuTimerFreq > 0 )
+    {
+        double gpuToMS = 1000.0 / pStats->gpuTimerFreq;
+        SetValue( FrameStat::GPUTime, (float)( (pStats->gpuTimeEnd - pStats->gpuTimeBegin) * gpuToMS ) );
+    }
+
+    // Memory is reported as -1 when unknown.
+    SetValue( FrameStat::TextureMemoryMB, std::max( pStats->textureMemoryUsed, (int64_t)0 ) / (1024.0f * 1024.0f) );
+    SetValue( FrameStat::RenderTargetMemoryMB, std::max( pStats->rtMemoryUsed, (int64_t)0 ) / (1024.0f * 1024.0f) );
+}
+
+void FrameStats::CommitFrame()
+{
+    for( int i=0; i<(int)FrameStat::Count; i++ )
+    {
+        m_Histograms[i].AddSample( m_CurrentValues[i] );
+    }
+
+    if( m_pCSVFile )
+    {
+        fprintf( m_pCSVFile, "%u", m_NumFramesCommitted );
+        for( int i=0; i<(int)FrameStat::Count; i++ )
+        {
+            fprintf( m_pCSVFile, ",%g", m_CurrentValues[i] );
+        }
+        fprintf( m_pCSVFile, "\n" );
+    }
+
+    for( int i=0; i<(int)FrameStat::Count; i++ )
+    {
+        m_CurrentValues[i] = 0;
+    }
+
+    m_NumFramesCommitted++;
+}
+
+bool FrameStats::StartCSV(const char* filename)
+{
+    StopCSV();
+
+    m_pCSVFile = OpenFile( filename, "w" );
+    if( m_pCSVFile == nullptr )
+    {
+        OutputMessage( "FrameStats: Failed to open %s for writing.\n", filename );
+        return false;
+    }
+
+    fprintf( m_pCSVFile, "Frame" );
+    for( int i=0; i<(int)FrameStat::Count; i++ )
+    {
+        fprintf( m_pCSVFile, ",%s", FrameStatNames[i] );
+    }
+    fprintf( m_pCSVFile, "\n" );
+
+    return true;
+}
+
+void FrameStats::StopCSV()
+{
+    if( m_pCSVFile )
+    {
+        fclose( m_pCSVFile );
+        m_pCSVFile = nullptr;
+    }
+}
+
+const char* FrameStats::GetStatName(FrameStat stat)
+{
+    return FrameStatNames[(int)stat];
+}
+
+void FrameStats::Editor_DisplayOverlay(bool* pOpen)
+{
+    ImGuiWindowFlags flags = ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav;
+
+    ImGuiViewport* viewport = ImGui::GetMainViewport();
+    ImGui::SetNextWindowPos( ImVec2( viewport->WorkPos.x + viewport->WorkSize.x - 10, viewport->WorkPos.y + 10 ), ImGuiCond_FirstUseEver, ImVec2( 1, 0 ) );
+    ImGui::SetNextWindowBgAlpha( 0.75f );
+
+    if( ImGui::Begin( "Debug Stats", pOpen, flags ) )
+    {
+        const RollingHistogram& frameTimes = GetHistogram( FrameStat::FrameTime );
+        ImGui::PlotLines( "##FrameTimes", frameTimes.GetSamples(), frameTimes.GetNumSamples(), frameTimes.GetOffset(),
+                          nullptr, 0.0f, std::max( frameTimes.GetMax(), 33.3f ), ImVec2( 400, 60 ) );
+
+        if( ImGui::BeginTable( "Debug Stats", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit ) )
+        {
+            ImGui::TableSetupColumn( "Stat" );
+            ImGui::TableSetupColumn( "Latest" );
+            ImGui::TableSetupColumn( "Avg" );
+            ImGui::TableSetupColumn( "P50" );
+            ImGui::TableSetupColumn( "P95" );
+            ImGui::TableSetupColumn( "P99" );
+            ImGui::TableSetupColumn( "Max" );
+            ImGui::TableHeadersRow();
+
+            for( int i=0; i<(int)FrameStat::Count; i++ )
+            {
+                const RollingHistogram& histogram = m_Histograms[i];
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::Text( "%s", FrameStatNames[i] );
+                ImGui::TableNextColumn(); ImGui::Text( "%0.2f", histogram.GetLatest() );
+                ImGui::TableNextColumn(); ImGui::Text( "%0.2f", histogram.GetAverage() );
+                ImGui::TableNextColumn(); ImGui::Text( "%0.2f", histogram.GetPercentile( 50 ) );
+                ImGui::TableNextColumn(); ImGui::Text( "%0.2f", histogram.GetPercentile( 95 ) );
+                ImGui::TableNextColumn(); ImGui::Text( "%0.2f", histogram.GetPercentile( 99 ) );
+                ImGui::TableNextColumn(); ImGui::Text( "%0.2f", histogram.GetMax() );
+            }
+
+            ImGui::EndTable();
+        }
+
+        if( ImGui::CollapsingHeader( "Allocations by Tag" ) )
+        {
+            AllocationTracker::Editor_DisplayTags();
+        }
+
+        if( IsWritingCSV() )
+        {
+            if( ImGui::Button( "Stop CSV" ) )
+                StopCSV();
+        }
+        else
+        {
+            if( ImGui::Button( "Write CSV" ) )
+                StartCSV( "FrameStats.csv" );
+        }
+    }
+    ImGui::End();
+}
+
+} // namespace fw
@@ -0,0 +1,128 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#pragma once
+
+namespace fw {
+
+// Rolling window of the most recent samples of a single value.
+class RollingHistogram
+{
+public:
+    static const uint32 c_MaxSamples = 300;
+
+    void AddSample(float value);
+    void Clear();
+
+    // Getters.
+    uint32 GetNumSamples() const { return m_NumSamples; }
+    float GetLatest() const;
+    float GetAverage() const;
+    float GetMax() const;
+    float GetPercentile(float percentile) const;
+
+    // For ImGui::PlotLines, the offset is the index of the oldest sample.
+    const float* GetSamples() const { return m_Samples; }
+    uint32 GetOffset() const { return m_NumSamples < c_MaxSamples ? 0 : m_NextIndex; }
+
+protected:
+    float m_Samples[c_MaxSamples] = {};
+    uint32 m_NextIndex = 0;
+    uint32 m_NumSamples = 0;
+};
+
+enum class FrameStat
+{
+    // CPU phase times from FWCore::Run, in milliseconds.
+    FrameTime,
+    StartFrame,
+    Update,
+    Draw,
+    EndFrame,
+    BGFXFrame,
+    FramePacing,
+
+    // From bgfx::getStats, for the last frame bgfx rendered.
+    DrawCalls,
+    RenderThreadTime,
+    GPUTime,
+    WaitRender,
+    WaitSubmit,
+    TextureMemoryMB,
+    RenderTargetMemoryMB,
+
+    // Framework counters, set by GameCore.
+    GameObjects,
+    Entities,
+    Resources,
+    EventsDispatched,
+    EventsQueued,
+
+    // From Scene, the culled count is summed over all views.
+    DrawListItems,
+    CulledDrawItems,
+
+    // From AllocationTracker, 0 unless FW_ALLOCATION_TRACKING is enabled.
+    Allocations,
+    AllocatedKB,
+
+    // Bytes allocated from FWCore's FrameArena, including heap overflow.
+    FrameArenaKB,
+
+    Count,
+};
+
+// Per-frame stats.
+// Values set during the frame are added to their histograms by CommitFrame, then reset to 0.
+class FrameStats
+{
+public:
+    // Adds the time spent in its scope to a stat.
+    class Timer
+    {
+    public:
+        Timer(FrameStats* pStats, FrameStat stat);
+        ~Timer();
+
+    protected:
+        FrameStats* m_pStats;
+        FrameStat m_Stat;
+        double m_StartTime;
+    };
+
+public:
+    FrameStats();
+    virtual ~FrameStats();
+
+    void SetValue(FrameStat stat, float value) { m_CurrentValues[(int)stat] = value; }
+    void AddValue(FrameStat stat, float value) { m_CurrentValues[(int)stat] += value; }
+    void GatherBGFXStats();
+    void CommitFrame();
+
+    // CSV output, one row per committed frame.
+    bool StartCSV(const char* filename);
+    void StopCSV();
+    bool IsWritingCSV() { return m_pCSVFile != nullptr; }
+
+    // Getters.
+    const RollingHistogram& GetHistogram(FrameStat stat) const { return m_Histograms[(int)stat]; }
+    static const char* GetStatName(FrameStat stat);
+
+    // Editor.
+    void Editor_DisplayOverlay(bool* pOpen);
+
+protected:
+    float m_CurrentValues[(int)FrameStat::Count] = {};
+    RollingHistogram m_Histograms[(int)FrameStat::Count];
+    uint32 m_NumFramesCommitted = 0;
+
+    FILE* m_pCSVFile = nullptr;
+};
+
+} // namespace fw
@@ -0,0 +1,99 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "CoreHeaders.h"
+#include "MappedFile.h"
+
+#if !FW_PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace fw {
+
+MappedFile* MappedFile::Open(const char* filename)
+{
+#if FW_PLATFORM_WINDOWS
+    HANDLE hFile = CreateFileA( filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+    if( hFile == INVALID_HANDLE_VALUE )
+        return nullptr;
+
+    LARGE_INTEGER size;
+    if( GetFileSizeEx( hFile, &size ) == false || size.QuadPart == 0 )
+    {
+        CloseHandle( hFile );
+        return nullptr;
+    }
+
+    HANDLE hMapping = CreateFileMappingA( hFile, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    if( hMapping == nullptr )
+    {
+        CloseHandle( hFile );
+        return nullptr;
+    }
+
+    void* pData = MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, 0 );
+    if( pData == nullptr )
+    {
+        CloseHandle( hMapping );
+        CloseHandle( hFile );
+        return nullptr;
+    }
+
+    MappedFile* pFile = new MappedFile();
+    pFile->m_pData = static_cast<const uint8*>( pData );
+    pFile->m_Size = (size_t)size.QuadPart;
+    pFile->m_hFile = hFile;
+    pFile->m_hMapping = hMapping;
+    return pFile;
+#else
+    int fd = open( filename, O_RDONLY );
+    if( fd == -1 )
+        return nullptr;
+
+    struct stat fileStat;
+    if( fstat( fd, &fileStat ) != 0 || fileStat.st_size == 0 )
+    {
+        close( fd );
+        return nullptr;
+    }
+
+    // The mapping holds its own reference to the file, so the descriptor isn't needed after this.
+    void* pData = mmap( nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    close( fd );
+    if( pData == MAP_FAILED )
+        return nullptr;
+
+    MappedFile* pFile = new MappedFile();
+    pFile->m_pData = static_cast<const uint8*>( pData );
+    pFile->m_Size = (size_t)fileStat.st_size;
+    return pFile;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#if FW_PLATFORM_WINDOWS
+    UnmapViewOfFile( m_pData );
+    CloseHandle( m_hMapping );
+    CloseHandle( m_hFile );
+#else
+    munmap( const_cast<uint8*>( m_pData ), m_Size );
+#endif
+}
+
+void MappedFile::Release()
+{
+    assert( m_RefCount > 0 );
+    if( --m_RefCount == 0 )
+        delete this;
+}
+
+} // namespace fw
@@ -0,0 +1,48 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#pragma once
+
+#include <atomic>
+
+namespace fw {
+
+// Read only memory mapped file.
+// Reference counted so the mapping can outlive its creator, e.g. while bgfx still holds a makeRef to it.
+// Open returns the file with one reference, call Release when done with it instead of deleting it.
+// AddRef and Release are thread safe, bgfx release callbacks come from the render thread.
+class MappedFile
+{
+public:
+    // Returns nullptr if the file can't be opened or is empty.
+    static MappedFile* Open(const char* filename);
+
+    void AddRef() { m_RefCount++; }
+    void Release();
+
+    // Getters.
+    const uint8* GetData() const { return m_pData; }
+    size_t GetSize() const { return m_Size; }
+
+protected:
+    MappedFile() {}
+    ~MappedFile();
+
+protected:
+    const uint8* m_pData = nullptr;
+    size_t m_Size = 0;
+    std::atomic<uint32> m_RefCount = 1;
+
+#if FW_PLATFORM_WINDOWS
+    HANDLE m_hFile = INVALID_HANDLE_VALUE;
+    HANDLE m_hMapping = nullptr;
+#endif
+};
+
+} // namespace fw
@@ -0,0 +1,163 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#pragma once
+
+#include <functional>
+
+namespace fw {
+
+// Index into an ObjectPool plus the generation of the slot when the object was created.
+// Once the object is destroyed the slot's generation changes, so old handles resolve to nullptr.
+struct PoolHandle
+{
+    static const uint32 c_InvalidIndex = 0xFFFFFFFF;
+
+    uint32 index = c_InvalidIndex;
+    uint32 generation = 0;
+
+    bool IsNull() const { return index == c_InvalidIndex; }
+    bool operator==(const PoolHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const PoolHandle& other) const { return !(*this == other); }
+};
+
+// Type erased access to a pool through a common base class, e.g. a pool of Players seen as GameObjects.
+template<typename Base> class ObjectPoolBase
+{
+public:
+    virtual ~ObjectPoolBase() {}
+
+    virtual Base* GetBase(PoolHandle handle) = 0;
+    virtual void Destroy(PoolHandle handle) = 0;
+    virtual void ForEachBase(const std::function<void(Base*)>& func) = 0;
+    virtual uint32 GetNumObjects() = 0;
+};
+
+// Stores objects in fixed size chunks, so pointers stay valid as the pool grows
+//   and objects of the same type sit next to each other in memory.
+// Freed slots are reused, and their generation is bumped so stale handles can be detected.
+template<typename T, typename Base = T> class ObjectPool : public ObjectPoolBase<Base>
+{
+public:
+    static const uint32 c_ObjectsPerChunk = 256;
+
+    ObjectPool() {}
+    virtual ~ObjectPool()
+    {
+        for( uint32 i=0; i<m_NumSlots; i++ )
+        {
+            Slot& slot = GetSlot( i );
+            if( slot.alive )
+                slot.GetObject()->~T();
+        }
+
+        for( Slot* pChunk : m_Chunks )
+        {
+            delete[] pChunk;
+        }
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    template<typename... Args> PoolHandle Create(Args&&... args)
+    {
+        uint32 index = m_FirstFreeSlot;
+        if( index == PoolHandle::c_InvalidIndex )
+        {
+            if( m_NumSlots == m_Chunks.size() * c_ObjectsPerChunk )
+            {
+                m_Chunks.push_back( new Slot[c_ObjectsPerChunk] );
+            }
+            index = m_NumSlots++;
+        }
+        else
+        {
+            m_FirstFreeSlot = GetSlot( index ).nextFreeSlot;
+        }
+
+        Slot& slot = GetSlot( index );
+        new (slot.storage) T( std::forward<Args>( args )... );
+        slot.alive = true;
+        m_NumObjects++;
+
+        return { index, slot.generation };
+    }
+
+    virtual void Destroy(PoolHandle handle) override
+    {
+        T* pObject = Get( handle );
+        assert( pObject != nullptr ); // Destroying a stale or null handle.
+        if( pObject == nullptr )
+            return;
+
+        pObject->~T();
+
+        Slot& slot = GetSlot( handle.index );
+        slot.alive = false;
+        slot.generation++;
+        if( slot.generation == 0 )
+            slot.generation = 1;
+        slot.nextFreeSlot = m_FirstFreeSlot;
+        m_FirstFreeSlot = handle.index;
+        m_NumObjects--;
+    }
+
+    // Returns nullptr if the object was destroyed.
+    T* Get(PoolHandle handle)
+    {
+        if( handle.index >= m_NumSlots )
+            return nullptr;
+
+        Slot& slot = GetSlot( handle.index );
+        if( slot.alive == false || slot.generation != handle.generation )
+            return nullptr;
+
+        return slot.GetObject();
+    }
+
+    bool IsValid(PoolHandle handle) { return Get( handle ) != nullptr; }
+
+    // Visits live objects in memory order.
+    template<typename Func> void ForEach(Func func)
+    {
+        for( uint32 i=0; i<m_NumSlots; i++ )
+        {
+            Slot& slot = GetSlot( i );
+            if( slot.alive )
+                func( slot.GetObject() );
+        }
+    }
+
+    // ObjectPoolBase.
+    virtual Base* GetBase(PoolHandle handle) override { return Get( handle ); }
+    virtual void ForEachBase(const std::function<void(Base*)>& func) override { ForEach( func ); }
+    virtual uint32 GetNumObjects() override { return m_NumObjects; }
+
+protected:
+    struct Slot
+    {
+        alignas(T) uint8 storage[sizeof(T)];
+        uint32 generation = 1;
+        uint32 nextFreeSlot = PoolHandle::c_InvalidIndex;
+        bool alive = false;
+
+        T* GetObject() { return reinterpret_cast<T*>( storage ); }
+    };
+
+    Slot& GetSlot(uint32 index) { return m_Chunks[index / c_ObjectsPerChunk][index % c_ObjectsPerChunk]; }
+
+protected:
+    std::vector<Slot*> m_Chunks;
+    uint32 m_NumSlots = 0;
+    uint32 m_NumObjects = 0;
+    uint32 m_FirstFreeSlot = PoolHandle::c_InvalidIndex;
+};
+
+} // namespace fw
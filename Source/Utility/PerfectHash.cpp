@@ -0,0 +1,157 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "CoreHeaders.h"
+
+#include <unordered_set>
+
+#include "PerfectHash.h"
+
+namespace fw {
+
+uint32 PerfectHashTable::Hash(const char* key, uint32 seed)
+{
+    // FNV-1a with the seed mixed into the offset basis, then a final avalanche so the low bits are usable.
+    uint32 hash = 2166136261u ^ (seed * 0x9E3779B9u);
+    for( const char* c = key; *c; c++ )
+    {
+        hash ^= (uint8)*c;
+        hash *= 16777619u;
+    }
+
+    hash ^= hash >> 16;
+    hash *= 0x7feb352du;
+    hash ^= hash >> 15;
+
+    return hash;
+}
+
+void PerfectHashTable::Build(const std::vector<std::string>& keys)
+{
+    // Duplicate keys always hash to the same slot, no seed can separate them.
+    assert( std::unordered_set<std::string>( keys.begin(), keys.end() ).size() == keys.size() );
+
+    m_Keys = keys;
+    m_Seeds.clear();
+    m_Slots.clear();
+
+    uint32 numKeys = (uint32)keys.size();
+    if( numKeys == 0 )
+        return;
+
+    // Start with buckets of a few keys each, smaller buckets are easier to place if that fails.
+    uint32 numBuckets = std::max( numKeys / 4, 1u );
+    while( PlaceKeys( numBuckets ) == false )
+    {
+        if( numBuckets == numKeys )
+        {
+            // Only duplicate keys should end up here, leave the table empty rather than guess.
+            assert( false );
+            m_Keys.clear();
+            m_Seeds.clear();
+            m_Slots.clear();
+            return;
+        }
+
+        numBuckets = std::min( numBuckets * 2, numKeys );
+    }
+}
+
+bool PerfectHashTable::PlaceKeys(uint32 numBuckets)
+{
+    uint32 numKeys = (uint32)m_Keys.size();
+
+    std::vector<std::vector<uint32>> buckets( numBuckets );
+    for( uint32 i=0; i<numKeys; i++ )
+    {
+        buckets[Hash( m_Keys[i].c_str(), 0 ) % numBuckets].push_back( i );
+    }
+
+    // Place the biggest buckets first, while there are lots of empty slots.
+    std::vector<uint32> bucketOrder( numBuckets );
+    for( uint32 i=0; i<numBuckets; i++ )
+        bucketOrder[i] = i;
+    std::sort( bucketOrder.begin(), bucketOrder.end(),
+        [&buckets](uint32 a, uint32 b) { return buckets[a].size() > buckets[b].size(); } );
+
+    m_Seeds.assign( numBuckets, 0 );
+    m_Slots.assign( numKeys, -1 );
+
+    std::vector<uint32> bucketSlots;
+    uint32 orderIndex = 0;
+    for( ; orderIndex<numBuckets; orderIndex++ )
+    {
+        std::vector<uint32>& bucket = buckets[bucketOrder[orderIndex]];
+        if( bucket.size() <= 1 )
+            break;
+
+        // Try seeds until every key in the bucket lands in a different empty slot.
+        bool placed = false;
+        for( uint32 seed=1; seed<=c_MaxSeedAttempts && placed == false; seed++ )
+        {
+            bucketSlots.clear();
+            bool fits = true;
+            for( uint32 keyIndex : bucket )
+            {
+                uint32 slot = Hash( m_Keys[keyIndex].c_str(), seed ) % numKeys;
+                if( m_Slots[slot] != -1 || std::find( bucketSlots.begin(), bucketSlots.end(), slot ) != bucketSlots.end() )
+                {
+                    fits = false;
+                    break;
+                }
+                bucketSlots.push_back( slot );
+            }
+
+            if( fits )
+            {
+                for( uint32 i=0; i<bucket.size(); i++ )
+                    m_Slots[bucketSlots[i]] = (int32)bucket[i];
+                m_Seeds[bucketOrder[orderIndex]] = (int32)seed;
+                placed = true;
+            }
+        }
+
+        if( placed == false )
+            return false;
+    }
+
+    // Buckets with a single key go straight into the remaining free slots.
+    uint32 freeSlot = 0;
+    for( ; orderIndex<numBuckets; orderIndex++ )
+    {
+        std::vector<uint32>& bucket = buckets[bucketOrder[orderIndex]];
+        if( bucket.empty() )
+            break;
+
+        while( m_Slots[freeSlot] != -1 )
+            freeSlot++;
+
+        m_Slots[freeSlot] = (int32)bucket[0];
+        m_Seeds[bucketOrder[orderIndex]] = -(int32)freeSlot - 1;
+    }
+
+    return true;
+}
+
+int32 PerfectHashTable::Find(const char* key) const
+{
+    if( m_Keys.empty() )
+        return -1;
+
+    int32 seed = m_Seeds[Hash( key, 0 ) % m_Seeds.size()];
+    uint32 slot = seed < 0 ? (uint32)(-seed - 1) : Hash( key, (uint32)seed ) % m_Slots.size();
+
+    int32 index = m_Slots[slot];
+    if( index == -1 || strcmp( m_Keys[index].c_str(), key ) != 0 )
+        return -1;
+
+    return index;
+}
+
+} // namespace fw
@@ -0,0 +1,45 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#pragma once
+
+namespace fw {
+
+// Maps a fixed set of unique strings to their index in the set, built once up front.
+// Uses hash and displace: a key's first hash picks a bucket and each bucket stores a seed for a second hash
+//   that sends all of its keys to different slots, so Find is two hashes and one string compare.
+// Keys not in the set return -1.
+// Keys must be unique, a set with duplicates asserts and is left empty.
+class PerfectHashTable
+{
+public:
+    PerfectHashTable() {}
+    virtual ~PerfectHashTable() {}
+
+    void Build(const std::vector<std::string>& keys);
+    int32 Find(const char* key) const;
+
+    // Getters.
+    uint32 GetNumKeys() const { return (uint32)m_Keys.size(); }
+    const std::string& GetKey(uint32 index) const { return m_Keys[index]; }
+
+protected:
+    // Seeds tried per bucket before giving up and splitting the keys into more buckets.
+    static const uint32 c_MaxSeedAttempts = 100000;
+
+    static uint32 Hash(const char* key, uint32 seed);
+    bool PlaceKeys(uint32 numBuckets);
+
+protected:
+    std::vector<std::string> m_Keys;
+    std::vector<int32> m_Seeds; // Per bucket, negative values are -(slot+1) for buckets with a single key.
+    std::vector<int32> m_Slots; // Index of the key in each slot.
+};
+
+} // namespace fw
@@ -0,0 +1,431 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "CoreHeaders.h"
+
+#include <atomic>
+#include <float.h>
+#include <mutex>
+
+#include "Profiler.h"
+#include "Utility/Utility.h"
+
+namespace fw {
+namespace Profiler {
+
+static const uint32 c_ZonesPerThread = 16384;
+static const uint32 c_MaxDepth = 64;
+static const uint32 c_NumFrameMarkers = 256;
+
+struct ThreadBuffer
+{
+    uint32 threadID = 0;
+    char name[32] = {};
+
+    // Finished zones, only written by the owning thread.
+    // numZones is the total ever written, readers use it to know which entries are complete.
+    Zone zones[c_ZonesPerThread];
+    std::atomic<uint64> numZones = 0;
+
+    // Zones that have begun but not ended.
+    const char* openNames[c_MaxDepth];
+    double openStartTimes[c_MaxDepth];
+    uint32 depth = 0;
+};
+
+struct CapturedThread
+{
+    uint32 threadID;
+    std::string name;
+    std::vector<Zone> zones;
+};
+
+// Off by default, so threads don't allocate zone buffers until someone is looking.
+static std::atomic<bool> g_Enabled = false;
+
+static std::mutex g_ThreadBuffersMutex;
+static std::vector<ThreadBuffer*> g_ThreadBuffers;
+static thread_local ThreadBuffer* t_pThreadBuffer = nullptr;
+static thread_local char t_ThreadName[32] = {};
+static thread_local uint32 t_UnbufferedDepth = 0; // Zones begun before the thread had a buffer.
+
+static double g_FrameStartTimes[c_NumFrameMarkers];
+static std::atomic<uint64> g_NumFrames = 0;
+
+static ThreadBuffer* GetThreadBuffer()
+{
+    if( t_pThreadBuffer == nullptr )
+    {
+        // Buffers are never freed, so a thread's zones can still be viewed after it exits.
+        ThreadBuffer* pBuffer = new ThreadBuffer;
+
+        std::lock_guard<std::mutex> lock( g_ThreadBuffersMutex );
+        pBuffer->threadID = (uint32)g_ThreadBuffers.size();
+        if( t_ThreadName[0] != '\0' )
+            strcpy( pBuffer->name, t_ThreadName );
+        else
+            snprintf( pBuffer->name, sizeof(pBuffer->name), "Thread %u", pBuffer->threadID );
+        g_ThreadBuffers.push_back( pBuffer );
+
+        t_pThreadBuffer = pBuffer;
+    }
+
+    return t_pThreadBuffer;
+}
+
+// Copy the finished zones from every thread that overlap the time range.
+static void CaptureZones(std::vector<CapturedThread>& threads, double startTime, double endTime)
+{
+    threads.clear();
+
+    std::lock_guard<std::mutex> lock( g_ThreadBuffersMutex );
+
+    std::vector<std::pair<uint64, Zone>> copiedZones;
+    for( ThreadBuffer* pBuffer : g_ThreadBuffers )
+    {
+        uint64 numZones = pBuffer->numZones.load( std::memory_order_acquire );
+        uint64 firstZone = numZones > c_ZonesPerThread ? numZones - c_ZonesPerThread : 0;
+
+        // Zones are written in the order they end, so walk backwards until they end before the range.
+        copiedZones.clear();
+        for( uint64 i=numZones; i>firstZone; i-- )
+        {
+            const Zone& zone = pBuffer->zones[(i-1) % c_ZonesPerThread];
+            if( zone.endTime < startTime )
+                break;
+
+            if( zone.startTime <= endTime )
+                copiedZones.push_back( { i-1, zone } );
+        }
+
+        // The owning thread keeps writing while we copy, drop anything it might have overwritten.
+        uint64 numZonesAfter = pBuffer->numZones.load( std::memory_order_acquire );
+        uint64 firstValidZone = numZonesAfter >= c_ZonesPerThread ? numZonesAfter - c_ZonesPerThread + 1 : 0;
+
+        CapturedThread thread;
+        thread.threadID = pBuffer->threadID;
+        thread.name = pBuffer->name;
+        for( auto it = copiedZones.rbegin(); it != copiedZones.rend(); it++ )
+        {
+            if( it->first >= firstValidZone )
+                thread.zones.push_back( it->second );
+        }
+
+        if( thread.zones.empty() == false )
+            threads.push_back( thread );
+    }
+}
+
+static ImU32 GetZoneColor(const char* name)
+{
+    // FNV-1a, so a zone keeps the same color every frame.
+    uint32 hash = 2166136261u;
+    for( const char* p = name; *p; p++ )
+    {
+        hash ^= (uint8)*p;
+        hash *= 16777619u;
+    }
+
+    return ImColor::HSV( (hash % 360) / 360.0f, 0.5f, 0.8f );
+}
+
+// Setup.
+
+void SetEnabled(bool enabled)
+{
+    g_Enabled = enabled;
+}
+
+bool IsEnabled()
+{
+    return g_Enabled;
+}
+
+void SetThreadName(const char* name)
+{
+    // Kept until the thread records its first zone, naming a thread doesn't allocate its buffer.
+    strncpy( t_ThreadName, name, sizeof(t_ThreadName)-1 );
+    t_ThreadName[sizeof(t_ThreadName)-1] = '\0';
+
+    ThreadBuffer* pBuffer = t_pThreadBuffer;
+    if( pBuffer )
+    {
+        std::lock_guard<std::mutex> lock( g_ThreadBuffersMutex );
+        strcpy( pBuffer->name, t_ThreadName );
+    }
+}
+
+// Recording.
+
+void BeginZone(const char* name)
+{
+    // Threads that haven't recorded anything yet only count zones while the profiler is disabled.
+    if( t_pThreadBuffer == nullptr && g_Enabled == false )
+    {
+        t_UnbufferedDepth++;
+        return;
+    }
+
+    ThreadBuffer* pBuffer = GetThreadBuffer();
+
+    // Zones nested too deeply are counted, but not recorded.
+    assert( pBuffer->depth < c_MaxDepth );
+    if( pBuffer->depth < c_MaxDepth )
+    {
+        // If the profiler is disabled, mark the zone so EndZone doesn't record it.
+        pBuffer->openNames[pBuffer->depth] = name;
+        pBuffer->openStartTimes[pBuffer->depth] = g_Enabled ? GetSystemTime() : -1.0;
+    }
+
+    pBuffer->depth++;
+}
+
+void EndZone()
+{
+    // Zones nest, so any begun before the buffer existed are the outermost ones and end last.
+    ThreadBuffer* pBuffer = t_pThreadBuffer;
+    if( pBuffer == nullptr || pBuffer->depth == 0 )
+    {
+        assert( t_UnbufferedDepth > 0 );
+        t_UnbufferedDepth--;
+        return;
+    }
+
+    pBuffer->depth--;
+
+    uint32 depth = pBuffer->depth;
+    if( depth >= c_MaxDepth || pBuffer->openStartTimes[depth] < 0 )
+        return;
+
+    uint64 index = pBuffer->numZones.load( std::memory_order_relaxed );
+
+    Zone& zone = pBuffer->zones[index % c_ZonesPerThread];
+    zone.name = pBuffer->openNames[depth];
+    zone.startTime = pBuffer->openStartTimes[depth];
+    zone.endTime = GetSystemTime();
+    zone.depth = depth;
+
+    pBuffer->numZones.store( index + 1, std::memory_order_release );
+}
+
+void MarkFrame()
+{
+    uint64 frame = g_NumFrames.load( std::memory_order_relaxed );
+    g_FrameStartTimes[frame % c_NumFrameMarkers] = GetSystemTime();
+    g_NumFrames.store( frame + 1, std::memory_order_release );
+}
+
+// Output.
+
+void Editor_DisplayTimeline()
+{
+    static bool s_Paused = false;
+    static std::vector<CapturedThread> s_Threads;
+    static double s_FrameStartTime = 0;
+    static double s_FrameEndTime = 0;
+
+    bool enabled = IsEnabled();
+    if( ImGui::Checkbox( "Enabled", &enabled ) )
+    {
+        SetEnabled( enabled );
+    }
+    ImGui::SameLine();
+    ImGui::Checkbox( "Paused", &s_Paused );
+    ImGui::SameLine();
+    if( ImGui::Button( "Export Chrome Trace" ) )
+    {
+        ExportChromeTrace( "Profile.json" );
+    }
+
+    // Grab the last complete frame.
+    if( s_Paused == false )
+    {
+        uint64 numFrames = g_NumFrames.load( std::memory_order_acquire );
+        if( numFrames >= 2 )
+        {
+            s_FrameStartTime = g_FrameStartTimes[(numFrames-2) % c_NumFrameMarkers];
+            s_FrameEndTime = g_FrameStartTimes[(numFrames-1) % c_NumFrameMarkers];
+            CaptureZones( s_Threads, s_FrameStartTime, s_FrameEndTime );
+        }
+    }
+
+    if( s_Threads.empty() )
+    {
+        ImGui::Text( "No zones recorded." );
+        return;
+    }
+
+    double frameDuration = s_FrameEndTime - s_FrameStartTime;
+    ImGui::Text( "Frame: %0.2f ms", frameDuration * 1000 );
+    ImGui::Separator();
+
+    // Timeline, each thread gets a lane per depth level.
+    ImDrawList* pDrawList = ImGui::GetWindowDrawList();
+    float laneHeight = ImGui::GetTextLineHeight() + 4;
+    float labelWidth = 100.0f;
+    float width = ImGui::GetContentRegionAvail().x;
+    float barsWidth = std::max( width - labelWidth, 1.0f );
+
+    for( const CapturedThread& thread : s_Threads )
+    {
+        uint32 numLanes = 1;
+        for( const Zone& zone : thread.zones )
+            numLanes = std::max( numLanes, zone.depth + 1 );
+
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        ImGui::Text( "%s", thread.name.c_str() );
+        ImGui::SetCursorScreenPos( origin );
+        ImGui::Dummy( ImVec2( width, numLanes * laneHeight ) );
+
+        for( const Zone& zone : thread.zones )
+        {
+            double start = std::max( zone.startTime, s_FrameStartTime ) - s_FrameStartTime;
+            double end = std::min( zone.endTime, s_FrameEndTime ) - s_FrameStartTime;
+
+            ImVec2 min( origin.x + labelWidth + (float)(start / frameDuration) * barsWidth, origin.y + zone.depth * laneHeight );
+            ImVec2 max( origin.x + labelWidth + (float)(end / frameDuration) * barsWidth, min.y + laneHeight - 1 );
+            if( max.x - min.x < 1 )
+                max.x = min.x + 1;
+
+            pDrawList->AddRectFilled( min, max, GetZoneColor( zone.name ) );
+
+            // Only label zones with room for a few characters.
+            if( max.x - min.x > 20 )
+            {
+                pDrawList->PushClipRect( min, max, true );
+                pDrawList->AddText( ImVec2( min.x + 2, min.y + 2 ), IM_COL32_BLACK, zone.name );
+                pDrawList->PopClipRect();
+            }
+
+            if( ImGui::IsMouseHoveringRect( min, max ) )
+            {
+                ImGui::SetTooltip( "%s: %0.3f ms", zone.name, (zone.endTime - zone.startTime) * 1000 );
+            }
+        }
+
+        ImGui::Separator();
+    }
+
+    // Totals for the frame, slowest first.
+    struct ZoneTotal
+    {
+        std::string threadName;
+        const char* name;
+        uint32 calls;
+        double time;
+    };
+
+    std::vector<ZoneTotal> totals;
+    for( const CapturedThread& thread : s_Threads )
+    {
+        std::map<std::string, ZoneTotal> threadTotals;
+        for( const Zone& zone : thread.zones )
+        {
+            auto it = threadTotals.find( zone.name );
+            if( it == threadTotals.end() )
+                it = threadTotals.insert( { zone.name, { thread.name, zone.name, 0, 0 } } ).first;
+
+            it->second.calls++;
+            it->second.time += std::min( zone.endTime, s_FrameEndTime ) - std::max( zone.startTime, s_FrameStartTime );
+        }
+
+        for( auto& pair : threadTotals )
+            totals.push_back( pair.second );
+    }
+
+    std::sort( totals.begin(), totals.end(), [](const ZoneTotal& a, const ZoneTotal& b) { return a.time > b.time; } );
+
+    if( ImGui::BeginTable( "Profiler Totals", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg ) )
+    {
+        ImGui::TableSetupColumn( "Thread" );
+        ImGui::TableSetupColumn( "Zone" );
+        ImGui::TableSetupColumn( "Calls" );
+        ImGui::TableSetupColumn( "Total (ms)" );
+        ImGui::TableHeadersRow();
+
+        for( const ZoneTotal& total : totals )
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::Text( "%s", total.threadName.c_str() );
+            ImGui::TableNextColumn(); ImGui::Text( "%s", total.name );
+            ImGui::TableNextColumn(); ImGui::Text( "%u", total.calls );
+            ImGui::TableNextColumn(); ImGui::Text( "%0.3f", total.time * 1000 );
+        }
+
+        ImGui::EndTable();
+    }
+}
+
+bool ExportChromeTrace(const char* filename)
+{
+    std::vector<CapturedThread> threads;
+    CaptureZones( threads, -DBL_MAX, DBL_MAX );
+
+    double baseTime = DBL_MAX;
+    for( const CapturedThread& thread : threads )
+    {
+        for( const Zone& zone : thread.zones )
+            baseTime = std::min( baseTime, zone.startTime );
+    }
+
+    // Chrome's trace event format, timestamps are in microseconds.
+    nlohmann::json jEvents = nlohmann::json::array();
+    uint32 numZones = 0;
+
+    for( const CapturedThread& thread : threads )
+    {
+        jEvents.push_back( { {"name", "thread_name"}, {"ph", "M"}, {"pid", 0}, {"tid", thread.threadID}, {"args", { {"name", thread.name} } } } );
+
+        for( const Zone& zone : thread.zones )
+        {
+            nlohmann::json jEvent;
+            jEvent["name"] = zone.name;
+            jEvent["ph"] = "X";
+            jEvent["ts"] = (zone.startTime - baseTime) * 1000000.0;
+            jEvent["dur"] = (zone.endTime - zone.startTime) * 1000000.0;
+            jEvent["pid"] = 0;
+            jEvent["tid"] = thread.threadID;
+            jEvents.push_back( jEvent );
+            numZones++;
+        }
+    }
+
+    // Frame boundaries as global instant events.
+    uint64 numFrames = g_NumFrames.load( std::memory_order_acquire );
+    uint64 firstFrame = numFrames > c_NumFrameMarkers ? numFrames - c_NumFrameMarkers : 0;
+    for( uint64 i=firstFrame; i<numFrames; i++ )
+    {
+        double frameStartTime = g_FrameStartTimes[i % c_NumFrameMarkers];
+        if( frameStartTime >= baseTime )
+        {
+            jEvents.push_back( { {"name", "Frame"}, {"ph", "i"}, {"s", "g"}, {"pid", 0}, {"tid", 0}, {"ts", (frameStartTime - baseTime) * 1000000.0} } );
+        }
+    }
+
+    nlohmann::json jTrace;
+    jTrace["traceEvents"] = jEvents;
+    jTrace["displayTimeUnit"] = "ms";
+    std::string jsonString = jTrace.dump();
+
+    FILE* fileHandle = OpenFile( filename, "wb" );
+    if( fileHandle == nullptr )
+    {
+        OutputMessage( "Profiler: Failed to open %s for writing.\n", filename );
+        return false;
+    }
+
+    fwrite( jsonString.c_str(), jsonString.length(), 1, fileHandle );
+    fclose( fileHandle );
+
+    OutputMessage( "Profiler: Exported %u zones to %s.\n", numZones, filename );
+    return true;
+}
+
+} // namespace Profiler
+} // namespace fw
@@ -0,0 +1,72 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#pragma once
+
+// Scoped CPU profiler.
+// Each thread records finished zones into its own ring buffer, so zones can be used from any thread without locking.
+// Recording starts disabled, a thread's buffer is allocated the first time it records a zone and kept after it exits.
+// Zone names aren't copied, they must be string literals or otherwise outlive the profiler.
+//
+// Usage:
+//    void MyFunction()
+//    {
+//        FW_PROFILE_SCOPE( "MyFunction" );
+//        ...
+//    }
+//
+// Define FW_PROFILER_ENABLED as 0 to compile out all zones.
+
+#ifndef FW_PROFILER_ENABLED
+#define FW_PROFILER_ENABLED 1
+#endif
+
+#define FW_PROFILE_CONCAT_INNER(a, b) a##b
+#define FW_PROFILE_CONCAT(a, b) FW_PROFILE_CONCAT_INNER(a, b)
+
+#if FW_PROFILER_ENABLED
+#define FW_PROFILE_SCOPE(name) fw::Profiler::Scope FW_PROFILE_CONCAT(fwProfileScope_, __LINE__)( name )
+#else
+#define FW_PROFILE_SCOPE(name)
+#endif
+
+namespace fw {
+namespace Profiler {
+
+struct Zone
+{
+    const char* name;
+    double startTime;
+    double endTime;
+    uint32 depth;
+};
+
+// Setup.
+void SetEnabled(bool enabled);
+bool IsEnabled();
+void SetThreadName(const char* name);
+
+// Recording.
+void BeginZone(const char* name);
+void EndZone();
+void MarkFrame(); // Called by FWCore once at the start of each frame.
+
+// Output.
+void Editor_DisplayTimeline();
+bool ExportChromeTrace(const char* filename);
+
+class Scope
+{
+public:
+    Scope(const char* name) { BeginZone( name ); }
+    ~Scope() { EndZone(); }
+};
+
+} // namespace Profiler
+} // namespace fw
@@ -10,6 +10,10 @@
 #include "CoreHeaders.h"
 #include "Utility.h"
 
+#if FW_PLATFORM_WINDOWS
+#include <timeapi.h>
+#endif
+
 namespace fw {
 
 void OutputMessage(const char* message, ...)
@@ -18,19 +22,37 @@ void OutputMessage(const char* message, ...)
     char szBuff[MAX_MESSAGE];
     va_list arg;
     va_start(arg, message);
+#if FW_PLATFORM_WINDOWS
     vsnprintf_s( szBuff, sizeof(szBuff), _TRUNCATE, message, arg );
+#else
+    vsnprintf( szBuff, sizeof(szBuff), message, arg );
+#endif
     va_end(arg);
 
     szBuff[MAX_MESSAGE-1] = 0; // vsnprintf_s might do this, but docs are unclear.
+#if FW_PLATFORM_WINDOWS
     OutputDebugString( szBuff );
+#else
+    fputs( szBuff, stderr );
+#endif
+}
+
+FILE* OpenFile(const char* filename, const char* mode)
+{
+    FILE* fileHandle = nullptr;
+#if FW_PLATFORM_WINDOWS
+    fopen_s( &fileHandle, filename, mode );
+#else
+    fileHandle = fopen( filename, mode );
+#endif
+    return fileHandle;
 }
 
 char* LoadCompleteFile(const char* filename, uint32* length)
 {
     char* fileContents = 0;
 
-    FILE* fileHandle;
-    errno_t error = fopen_s( &fileHandle, filename, "rb" );
+    FILE* fileHandle = OpenFile( filename, "rb" );
 
     if( fileHandle )
     {
@@ -53,8 +75,7 @@ char* LoadCompleteFile(const char* filename, uint32* length)
 
 void SaveCompleteFile(const char* filename, const char* fileContents, uint32 length)
 {
-    FILE* fileHandle;
-    errno_t error = fopen_s( &fileHandle, filename, "wb" );
+    FILE* fileHandle = OpenFile( filename, "wb" );
 
     if( fileHandle )
     {
@@ -65,27 +86,65 @@ void SaveCompleteFile(const char* filename, const char* fileContents, uint32 len
 
 double GetSystemTime()
 {
-    uint64 freq;
-    uint64 time;
+#if FW_PLATFORM_WINDOWS
+    // The frequency is fixed at boot, only query it once. Static initialization is thread safe.
+    static const uint64 freq = []()
+    {
+        uint64 frequency;
+        QueryPerformanceFrequency( (LARGE_INTEGER*)&frequency );
+        return frequency;
+    }();
 
-    QueryPerformanceFrequency( (LARGE_INTEGER*)&freq );
+    uint64 time;
     QueryPerformanceCounter( (LARGE_INTEGER*)&time );
 
     double timeseconds = (double)time / freq;
+#else
+    // Monotonic, so it won't jump if the wall clock is adjusted.
+    timespec time;
+    clock_gettime( CLOCK_MONOTONIC, &time );
+
+    double timeseconds = (double)time.tv_sec + (double)time.tv_nsec / 1000000000.0;
+#endif
 
     return timeseconds;
 }
 
 double GetSystemTimeSinceGameStart()
 {
-    static double starttime = -1;
-
-    if( starttime == -1 )
-        starttime = GetSystemTime();
+    static const double starttime = GetSystemTime();
 
     return GetSystemTime() - starttime;
 }
 
+// Windows sleeps in 15.6ms increments by default, this drops it to 1ms.
+// It raises the timer rate for the whole system, so only enable it while sleeping is needed.
+void SetHighResolutionSleep(bool enabled)
+{
+#if FW_PLATFORM_WINDOWS
+    if( enabled )
+        timeBeginPeriod( 1 );
+    else
+        timeEndPeriod( 1 );
+#endif
+}
+
+// The OS can oversleep, callers needing precision should sleep less and spin for the rest.
+void SleepSeconds(double seconds)
+{
+    if( seconds <= 0 )
+        return;
+
+#if FW_PLATFORM_WINDOWS
+    Sleep( (DWORD)( seconds * 1000 ) );
+#else
+    timespec time;
+    time.tv_sec = (time_t)seconds;
+    time.tv_nsec = (long)( (seconds - time.tv_sec) * 1000000000.0 );
+    nanosleep( &time, nullptr );
+#endif
+}
+
 std::string GetFileNameFromPath(const char* path)
 {
     std::string filename = path;
@@ -12,10 +12,13 @@
 namespace fw {
 
 void OutputMessage(const char* message, ...);
+FILE* OpenFile(const char* filename, const char* mode);
 char* LoadCompleteFile(const char* filename, uint32* length);
 void SaveCompleteFile(const char* filename, const char* fileContents, uint32 length);
 double GetSystemTime();
 double GetSystemTimeSinceGameStart();
+void SetHighResolutionSleep(bool enabled);
+void SleepSeconds(double seconds);
 std::string GetFileNameFromPath(const char* path);
 
 } // namespace fw
@@ -0,0 +1,316 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+// Atlas builder.
+// Packs loose PNGs into a single atlas PNG plus a SpriteSheet json file, run it as part of the content build.
+// Sprites are named after their file, without the path or extension.
+//
+// Each image gets a border of --padding pixels filled with copies of its edge pixels, so filtering and the
+//   first few mip levels don't pull in neighbouring sprites. Every mip level halves the border, so a padding
+//   of 2^n with --align 2^n keeps n levels clean.
+//
+// Y in the json is measured from the bottom of the atlas, to match Texture flipping images when they're loaded.
+// At runtime, ResourceManager::RemapMaterialsToAtlas points materials using the original textures into the atlas.
+//
+// Usage:
+//    AtlasBuilder [--padding P] [--align A] [--max-size S] --output name file.png|folder ...
+//    Writes name.png and name.json.
+
+#include "Framework.h"
+
+#include <filesystem>
+
+#include "stb/stb_image.h"
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb/stb_image_write.h"
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "stb/stb_rect_pack.h"
+
+//====================
+// Settings
+//====================
+
+struct AtlasSettings
+{
+    uint32 padding = 2;
+    uint32 align = 4;
+    uint32 maxSize = 4096;
+    const char* outputName = nullptr;
+    std::vector<std::string> inputs;
+};
+
+static bool ParseArguments(int argc, char** argv, AtlasSettings& settings)
+{
+    for( int i=1; i<argc; i++ )
+    {
+        const char* arg = argv[i];
+
+        // Anything that isn't an option is an input file or folder.
+        if( strncmp( arg, "--", 2 ) != 0 )
+        {
+            settings.inputs.push_back( arg );
+            continue;
+        }
+
+        const char* value = i+1 < argc ? argv[i+1] : nullptr;
+        if( value == nullptr )
+        {
+            fprintf( stderr, "Missing value for %s\n", arg );
+            return false;
+        }
+
+        if(      strcmp( arg, "--padding" ) == 0 )  settings.padding = (uint32)atoi( value );
+        else if( strcmp( arg, "--align" ) == 0 )    settings.align = (uint32)atoi( value );
+        else if( strcmp( arg, "--max-size" ) == 0 ) settings.maxSize = (uint32)atoi( value );
+        else if( strcmp( arg, "--output" ) == 0 )   settings.outputName = value;
+        else
+        {
+            fprintf( stderr, "Unknown argument: %s\n", arg );
+            return false;
+        }
+
+        i++;
+    }
+
+    if( settings.outputName == nullptr || settings.inputs.empty() )
+    {
+        fprintf( stderr, "Usage: AtlasBuilder [--padding P] [--align A] [--max-size S] --output name file.png|folder ...\n" );
+        return false;
+    }
+
+    if( settings.align == 0 )
+    {
+        fprintf( stderr, "--align must be greater than 0\n" );
+        return false;
+    }
+
+    return true;
+}
+
+//====================
+// Images
+//====================
+
+struct SourceImage
+{
+    std::string name;
+    int width = 0;
+    int height = 0;
+    unsigned char* pixels = nullptr; // RGBA, top row first.
+
+    // Position of the image in the atlas, not including padding.
+    int x = 0;
+    int y = 0;
+};
+
+static void AddImage(const std::filesystem::path& path, std::vector<SourceImage>& images)
+{
+    std::string name = path.stem().string();
+    for( SourceImage& image : images )
+    {
+        if( image.name == name )
+        {
+            fprintf( stderr, "Skipping %s, an image named %s was already added\n", path.string().c_str(), name.c_str() );
+            return;
+        }
+    }
+
+    SourceImage image;
+    int channels;
+    image.name = name;
+    image.pixels = stbi_load( path.string().c_str(), &image.width, &image.height, &channels, 4 );
+    if( image.pixels == nullptr )
+    {
+        fprintf( stderr, "Failed to load %s\n", path.string().c_str() );
+        return;
+    }
+
+    images.push_back( image );
+}
+
+static std::vector<SourceImage> LoadImages(const AtlasSettings& settings)
+{
+    stbi_set_flip_vertically_on_load( false );
+
+    std::vector<SourceImage> images;
+    for( const std::string& input : settings.inputs )
+    {
+        std::filesystem::path path( input );
+        if( std::filesystem::is_directory( path ) )
+        {
+            // Sorted so the output doesn't depend on the order the OS lists files in.
+            std::vector<std::filesystem::path> files;
+            for( const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator( path ) )
+            {
+                if( entry.is_regular_file() && entry.path().extension() == ".png" )
+                    files.push_back( entry.path() );
+            }
+            std::sort( files.begin(), files.end() );
+
+            for( const std::filesystem::path& file : files )
+                AddImage( file, images );
+        }
+        else
+        {
+            AddImage( path, images );
+        }
+    }
+
+    return images;
+}
+
+//====================
+// Packing
+//====================
+
+static uint32 AlignUp(uint32 value, uint32 align)
+{
+    return (value + align - 1) / align * align;
+}
+
+// Tries power of 2 atlas sizes, smallest first, until everything fits. Returns false if nothing up to maxSize works.
+static bool PackImages(std::vector<SourceImage>& images, const AtlasSettings& settings, uint32* pWidth, uint32* pHeight)
+{
+    std::vector<stbrp_rect> rects( images.size() );
+    for( size_t i=0; i<images.size(); i++ )
+    {
+        rects[i].id = (int)i;
+        rects[i].w = AlignUp( images[i].width + settings.padding * 2, settings.align );
+        rects[i].h = AlignUp( images[i].height + settings.padding * 2, settings.align );
+    }
+
+    uint32 width = 64;
+    uint32 height = 64;
+    while( width <= settings.maxSize && height <= settings.maxSize )
+    {
+        std::vector<stbrp_node> nodes( width );
+        stbrp_context context;
+        stbrp_init_target( &context, width, height, nodes.data(), (int)nodes.size() );
+
+        if( stbrp_pack_rects( &context, rects.data(), (int)rects.size() ) )
+        {
+            for( const stbrp_rect& rect : rects )
+            {
+                images[rect.id].x = rect.x + settings.padding;
+                images[rect.id].y = rect.y + settings.padding;
+            }
+
+            *pWidth = width;
+            *pHeight = height;
+            return true;
+        }
+
+        // Grow the width first, then the height.
+        if( width == height )
+            width *= 2;
+        else
+            height *= 2;
+    }
+
+    return false;
+}
+
+// Copies an image into the atlas, with its edge pixels repeated out into the padding.
+static void BlitWithBorder(const SourceImage& image, uint32 padding, unsigned char* pAtlas, uint32 atlasWidth)
+{
+    int border = (int)padding;
+    for( int y=-border; y<image.height + border; y++ )
+    {
+        int srcY = std::clamp( y, 0, image.height - 1 );
+        for( int x=-border; x<image.width + border; x++ )
+        {
+            int srcX = std::clamp( x, 0, image.width - 1 );
+
+            const unsigned char* pSrc = &image.pixels[(srcY * image.width + srcX) * 4];
+            unsigned char* pDest = &pAtlas[((image.y + y) * atlasWidth + (image.x + x)) * 4];
+            memcpy( pDest, pSrc, 4 );
+        }
+    }
+}
+
+//====================
+// Main
+//====================
+
+int main(int argc, char** argv)
+{
+    AtlasSettings settings;
+    if( ParseArguments( argc, argv, settings ) == false )
+        return 1;
+
+    std::vector<SourceImage> images = LoadImages( settings );
+    if( images.empty() )
+    {
+        fprintf( stderr, "No images to pack\n" );
+        return 1;
+    }
+
+    // Biggest first packs tighter, then the name keeps the result stable between runs.
+    std::sort( images.begin(), images.end(),
+        [](const SourceImage& a, const SourceImage& b)
+        {
+            if( a.height != b.height )
+                return a.height > b.height;
+            return a.name < b.name;
+        }
+    );
+
+    uint32 atlasWidth = 0;
+    uint32 atlasHeight = 0;
+    if( PackImages( images, settings, &atlasWidth, &atlasHeight ) == false )
+    {
+        fprintf( stderr, "Images don't fit in a %dx%d atlas\n", settings.maxSize, settings.maxSize );
+        return 1;
+    }
+
+    std::vector<unsigned char> atlas( atlasWidth * atlasHeight * 4, 0 );
+    uint64 usedPixels = 0;
+    for( const SourceImage& image : images )
+    {
+        BlitWithBorder( image, settings.padding, atlas.data(), atlasWidth );
+        usedPixels += (uint64)image.width * image.height;
+    }
+
+    std::string pngFilename = std::string( settings.outputName ) + ".png";
+    if( stbi_write_png( pngFilename.c_str(), atlasWidth, atlasHeight, 4, atlas.data(), atlasWidth * 4 ) == 0 )
+    {
+        fprintf( stderr, "Failed to write %s\n", pngFilename.c_str() );
+        return 1;
+    }
+
+    // Same layout SpriteSheet loads.
+    nlohmann::json jAtlas;
+    jAtlas["Width"] = atlasWidth;
+    jAtlas["Height"] = atlasHeight;
+    nlohmann::json jSpriteArray = nlohmann::json::array();
+    for( const SourceImage& image : images )
+    {
+        nlohmann::json jSprite;
+        jSprite["Name"] = image.name;
+        jSprite["X"] = image.x;
+        jSprite["Y"] = atlasHeight - (image.y + image.height);
+        jSprite["W"] = image.width;
+        jSprite["H"] = image.height;
+        jSpriteArray.push_back( jSprite );
+    }
+    jAtlas["Sprites"] = jSpriteArray;
+
+    std::string jsonFilename = std::string( settings.outputName ) + ".json";
+    std::string jsonString = jAtlas.dump( 4 );
+    fw::SaveCompleteFile( jsonFilename.c_str(), jsonString.c_str(), (uint32)jsonString.length() );
+
+    printf( "Packed %d images into %dx%d, %.1f%% used\n", (int)images.size(), atlasWidth, atlasHeight, 100.0 * usedPixels / ((uint64)atlasWidth * atlasHeight) );
+
+    for( SourceImage& image : images )
+    {
+        stbi_image_free( image.pixels );
+    }
+
+    return 0;
+}
@@ -0,0 +1,431 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+// Headless benchmark.
+// Builds a synthetic scene of N entities sharing M materials, then times the update,
+//   transform and draw submission passes against bgfx's Noop renderer for a fixed number of frames.
+// The scene is viewed through a perspective camera that only sees part of it, and the mesh has 2 LODs.
+// Results are written as JSON, to stdout or to the file passed with --output.
+//
+// --mode manual calls the core system functions directly, without culling or LODs:
+//   the "transforms" pass updates the transforms and the "submit" pass draws every mesh.
+// --mode pipeline draws the way games do, through Scene::Prepare and Scene::DrawIntoView, using --threads worker threads (0 for all):
+//   the "prepare" pass updates the transforms and builds and sorts the draw list,
+//   the "drawIntoView" pass culls against the camera, picks LODs and submits.
+// The "store" pass covers both passes in either mode.
+// --submit parallel splits pipeline mode's submission across the task scheduler's threads, one bgfx encoder each.
+//
+// Usage:
+//    FrameworkBenchmark [--entities N] [--materials M] [--frames F] [--warmup W] [--seed S]
+//                       [--mode manual|pipeline] [--threads T] [--submit serial|parallel] [--output file.json]
+
+#include "Framework.h"
+
+//====================
+// Settings
+//====================
+
+struct BenchmarkSettings
+{
+    uint32 numEntities = 10000;
+    uint32 numMaterials = 16;
+    uint32 numFrames = 300;
+    uint32 numWarmupFrames = 30;
+    uint32 seed = 12345;
+    bool usePipeline = false;
+    uint32 numThreads = 0;
+    bool parallelSubmit = false;
+    const char* outputFilename = nullptr;
+};
+
+static bool ParseArguments(int argc, char** argv, BenchmarkSettings& settings)
+{
+    for( int i=1; i<argc; i++ )
+    {
+        const char* arg = argv[i];
+        const char* value = i+1 < argc ? argv[i+1] : nullptr;
+
+        if( value == nullptr )
+        {
+            fprintf( stderr, "Missing value for %s\n", arg );
+            return false;
+        }
+
+        if(      strcmp( arg, "--entities" ) == 0 )  settings.numEntities = (uint32)atoi( value );
+        else if( strcmp( arg, "--materials" ) == 0 ) settings.numMaterials = (uint32)atoi( value );
+        else if( strcmp( arg, "--frames" ) == 0 )    settings.numFrames = (uint32)atoi( value );
+        else if( strcmp( arg, "--warmup" ) == 0 )    settings.numWarmupFrames = (uint32)atoi( value );
+        else if( strcmp( arg, "--seed" ) == 0 )      settings.seed = (uint32)atoi( value );
+        else if( strcmp( arg, "--threads" ) == 0 )   settings.numThreads = (uint32)atoi( value );
+        else if( strcmp( arg, "--output" ) == 0 )    settings.outputFilename = value;
+        else if( strcmp( arg, "--mode" ) == 0 )
+        {
+            if(      strcmp( value, "manual" ) == 0 )   settings.usePipeline = false;
+            else if( strcmp( value, "pipeline" ) == 0 ) settings.usePipeline = true;
+            else
+            {
+                fprintf( stderr, "Unknown mode: %s\n", value );
+                return false;
+            }
+        }
+        else if( strcmp( arg, "--submit" ) == 0 )
+        {
+            if(      strcmp( value, "serial" ) == 0 )   settings.parallelSubmit = false;
+            else if( strcmp( value, "parallel" ) == 0 ) settings.parallelSubmit = true;
+            else
+            {
+                fprintf( stderr, "Unknown submit mode: %s\n", value );
+                return false;
+            }
+        }
+        else
+        {
+            fprintf( stderr, "Unknown argument: %s\n", arg );
+            return false;
+        }
+
+        i++;
+    }
+
+    if( settings.numMaterials == 0 || settings.numFrames == 0 )
+    {
+        fprintf( stderr, "--materials and --frames must be greater than 0\n" );
+        return false;
+    }
+
+    return true;
+}
+
+//====================
+// Timings
+//====================
+
+class PassTimings
+{
+public:
+    void AddSample(double seconds) { m_Samples.push_back( seconds ); }
+
+    nlohmann::json ToJSON(uint32 numEntities)
+    {
+        std::vector<double> sorted = m_Samples;
+        std::sort( sorted.begin(), sorted.end() );
+
+        double total = 0;
+        for( double sample : sorted )
+            total += sample;
+        double average = sorted.empty() ? 0 : total / sorted.size();
+
+        nlohmann::json jPass;
+        jPass["avgMs"] = average * 1000.0;
+        jPass["p50Ms"] = GetPercentile( sorted, 50 ) * 1000.0;
+        jPass["p95Ms"] = GetPercentile( sorted, 95 ) * 1000.0;
+        jPass["p99Ms"] = GetPercentile( sorted, 99 ) * 1000.0;
+        jPass["maxMs"] = sorted.empty() ? 0 : sorted.back() * 1000.0;
+        jPass["nsPerEntity"] = numEntities ? average * 1000000000.0 / numEntities : 0;
+        return jPass;
+    }
+
+protected:
+    static double GetPercentile(const std::vector<double>& sorted, double percentile)
+    {
+        if( sorted.empty() )
+            return 0;
+
+        size_t index = (size_t)( percentile / 100.0 * (sorted.size() - 1) + 0.5 );
+        return sorted[std::min( index, sorted.size() - 1 )];
+    }
+
+protected:
+    std::vector<double> m_Samples;
+};
+
+//====================
+// BenchmarkFramework
+//====================
+
+// FWCore::Run isn't used, so the benchmark ends its own frames.
+// Advancing the frame count keeps view projections, draw list preparation and LOD selection per frame.
+class BenchmarkFramework : public fw::FWCore
+{
+public:
+    BenchmarkFramework(uint32 width, uint32 height)
+        : fw::FWCore( width, height, bgfx::RendererType::Noop )
+    {
+    }
+
+    void EndFrame()
+    {
+        m_FrameCount = bgfx::frame();
+    }
+};
+
+//====================
+// BenchmarkScene
+//====================
+
+class BenchmarkScene : public fw::Scene
+{
+public:
+    BenchmarkScene(fw::GameCore* pGameCore)
+        : fw::Scene( pGameCore )
+    {
+    }
+
+    void CreateObjects(const BenchmarkSettings& settings, fw::Mesh* pMesh, std::vector<fw::Material*>& materials)
+    {
+        // Same seed, same scene.
+        fw::Random::Generator generator( settings.seed );
+
+        ReserveGameObjects( settings.numEntities );
+        for( uint32 i=0; i<settings.numEntities; i++ )
+        {
+            fw::vec3 pos( generator.Float( -100, 100 ), generator.Float( -100, 100 ), generator.Float( -100, 100 ) );
+            fw::Material* pMaterial = materials[generator.Int( 0, (int32)materials.size() - 1 )];
+
+            fw::GameObject* pObject = CreateGameObject( "Object", pos, pMesh, pMaterial );
+            fw::TransformData& transform = pObject->GetEntity().ensure<fw::TransformData>();
+            transform.rotation = fw::vec3( generator.Float( 360 ), generator.Float( 360 ), generator.Float( 360 ) );
+            transform.scale = fw::vec3( generator.Float( 0.5f, 2.0f ) );
+        }
+    }
+};
+
+//====================
+// BenchmarkGame
+//====================
+
+struct VertexFormat_Pos
+{
+    fw::vec3 pos;
+
+    static void InitVertexLayout()
+    {
+        s_VertexLayout
+            .begin()
+            .add( bgfx::Attrib::Position, 3, bgfx::AttribType::Float )
+            .end();
+    }
+
+    static bgfx::VertexLayout s_VertexLayout;
+};
+bgfx::VertexLayout VertexFormat_Pos::s_VertexLayout;
+
+static const VertexFormat_Pos g_QuadVerts[] =
+{
+    { fw::vec3( -0.5f, -0.5f, 0.0f ) },
+    { fw::vec3( -0.5f,  0.5f, 0.0f ) },
+    { fw::vec3(  0.5f,  0.5f, 0.0f ) },
+    { fw::vec3(  0.5f, -0.5f, 0.0f ) },
+};
+
+static const uint16 g_QuadIndices[] = { 0,1,2, 0,2,3 };
+
+// Distant quads drop to a single triangle.
+static const std::vector<fw::Mesh::LOD> g_QuadLODs =
+{
+    { 0, 6, 0.01f },
+    { 0, 3, 0.0f },
+};
+
+class BenchmarkGame : public fw::GameCore
+{
+public:
+    BenchmarkGame(BenchmarkFramework& framework, const BenchmarkSettings& settings)
+        : fw::GameCore( framework )
+        , m_Framework( framework )
+        , m_Settings( settings )
+    {
+        m_pUniforms = new fw::Uniforms();
+        m_pResources = new fw::ResourceManager();
+        m_pEventManager = new fw::EventManager();
+
+        // The shader is created without files, so its program is invalid.
+        // bgfx still accepts the draws, then discards them before they reach the Noop renderer.
+        VertexFormat_Pos::InitVertexLayout();
+        m_pResources->AddShader( new fw::ShaderProgram( "Benchmark" ) );
+        m_pResources->AddMesh( new fw::Mesh( "Quad", VertexFormat_Pos::s_VertexLayout, g_QuadVerts, sizeof(g_QuadVerts), g_QuadIndices, sizeof(g_QuadIndices) ) );
+        m_pResources->GetMesh( "Quad" )->SetLODs( g_QuadLODs );
+
+        // Resources keep a pointer to their name.
+        m_MaterialNames.resize( settings.numMaterials );
+        for( uint32 i=0; i<settings.numMaterials; i++ )
+        {
+            m_MaterialNames[i] = "Material" + std::to_string( i );
+            fw::color4f color( i / (float)settings.numMaterials, 1.0f, 1.0f, 1.0f );
+            fw::Material* pMaterial = new fw::Material( m_MaterialNames[i].c_str(), m_pResources->GetShader( "Benchmark" ), nullptr, color, false );
+            m_pResources->AddMaterial( pMaterial );
+            m_Materials.push_back( pMaterial );
+        }
+
+        BenchmarkScene* pScene = new BenchmarkScene( this );
+        pScene->Init();
+        pScene->CreateObjects( settings, m_pResources->GetMesh( "Quad" ), m_Materials );
+        m_pActiveScene = pScene;
+    }
+
+    virtual ~BenchmarkGame()
+    {
+        delete m_pActiveScene;
+        delete m_pResources;
+    }
+
+    nlohmann::json Run()
+    {
+        const int viewID = 0;
+
+        // Looking at the scene from outside, objects are spread over -100 to 100 on each axis.
+        // A 45 degree view sees about half of the near side and more of the far side, the rest is culled.
+        float aspect = m_FWCore.GetWindowClientWidth() / (float)m_FWCore.GetWindowClientHeight();
+        fw::mat4 viewMatrix;
+        fw::mat4 projMatrix;
+        viewMatrix.CreateLookAtView( fw::vec3( 0, 0, -250 ), fw::vec3( 0, 1, 0 ), fw::vec3( 0, 0, 0 ) );
+        projMatrix.CreatePerspectiveVFoV( 45.0f, aspect, 1.0f, 500.0f );
+
+        fw::ComponentManager* pComponentManager = m_pActiveScene->GetComponentManager();
+
+        PassTimings updateTimings;
+        PassTimings transformTimings;
+        PassTimings submitTimings;
+        PassTimings storeTimings;
+        PassTimings bgfxFrameTimings;
+        PassTimings frameTimings;
+        std::vector<uint64> allocationsPerFrame;
+        uint64 totalBytesAllocated = 0;
+
+        uint32 totalFrames = m_Settings.numWarmupFrames + m_Settings.numFrames;
+        for( uint32 frame=0; frame<totalFrames; frame++ )
+        {
+            fw::AllocationTracker::Counts allocationsBefore = fw::AllocationTracker::GetTotals();
+
+            double startTime = fw::GetSystemTime();
+
+            m_pActiveScene->Update( 1/60.0f );
+            double updateTime = fw::GetSystemTime();
+
+            bgfx::setViewRect( viewID, 0, 0, m_FWCore.GetWindowClientWidth(), m_FWCore.GetWindowClientHeight() );
+            m_FWCore.SetViewTransform( viewID, viewMatrix, projMatrix );
+
+            double transformTime;
+            if( m_Settings.usePipeline )
+            {
+                m_pActiveScene->Prepare();
+                transformTime = fw::GetSystemTime();
+
+                m_pActiveScene->DrawIntoView( viewID );
+            }
+            else
+            {
+                fw::System_UpdateAllTransforms( pComponentManager );
+                transformTime = fw::GetSystemTime();
+
+                fw::System_DrawAllMeshes( pComponentManager, viewID, m_pUniforms );
+            }
+            double submitTime = fw::GetSystemTime();
+
+            m_Framework.EndFrame();
+            double endTime = fw::GetSystemTime();
+
+            if( frame < m_Settings.numWarmupFrames )
+                continue;
+
+            updateTimings.AddSample( updateTime - startTime );
+            transformTimings.AddSample( transformTime - updateTime );
+            submitTimings.AddSample( submitTime - transformTime );
+            storeTimings.AddSample( submitTime - updateTime );
+            bgfxFrameTimings.AddSample( endTime - submitTime );
+            frameTimings.AddSample( endTime - startTime );
+
+            fw::AllocationTracker::Counts allocationsAfter = fw::AllocationTracker::GetTotals();
+            allocationsPerFrame.push_back( allocationsAfter.numAllocations - allocationsBefore.numAllocations );
+            totalBytesAllocated += allocationsAfter.numBytes - allocationsBefore.numBytes;
+        }
+
+        // Results.
+        uint32 numEntities = m_Settings.numEntities;
+
+        nlohmann::json jResults;
+        jResults["renderer"] = bgfx::getRendererName( bgfx::getRendererType() );
+        jResults["settings"]["entities"] = m_Settings.numEntities;
+        jResults["settings"]["materials"] = m_Settings.numMaterials;
+        jResults["settings"]["frames"] = m_Settings.numFrames;
+        jResults["settings"]["warmupFrames"] = m_Settings.numWarmupFrames;
+        jResults["settings"]["seed"] = m_Settings.seed;
+        jResults["settings"]["mode"] = m_Settings.usePipeline ? "pipeline" : "manual";
+        jResults["settings"]["threads"] = m_FWCore.GetNumWorkerThreads();
+        jResults["settings"]["submit"] = m_Settings.parallelSubmit ? "parallel" : "serial";
+
+        jResults["passes"]["update"] = updateTimings.ToJSON( numEntities );
+        jResults["passes"][m_Settings.usePipeline ? "prepare" : "transforms"] = transformTimings.ToJSON( numEntities );
+        jResults["passes"][m_Settings.usePipeline ? "drawIntoView" : "submit"] = submitTimings.ToJSON( numEntities );
+        jResults["passes"]["store"] = storeTimings.ToJSON( numEntities );
+        jResults["passes"]["bgfxFrame"] = bgfxFrameTimings.ToJSON( numEntities );
+        jResults["passes"]["frame"] = frameTimings.ToJSON( numEntities );
+
+        // Allocations are only counted when the framework is built with FW_ALLOCATION_TRACKING.
+        // flecs allocates through malloc, so its internal allocations aren't included.
+        if( fw::AllocationTracker::IsEnabled() )
+        {
+            uint64 totalAllocations = 0;
+            uint64 maxAllocations = 0;
+            for( uint64 count : allocationsPerFrame )
+            {
+                totalAllocations += count;
+                maxAllocations = std::max( maxAllocations, count );
+            }
+            jResults["allocations"]["perFrameAvg"] = (double)totalAllocations / m_Settings.numFrames;
+            jResults["allocations"]["perFrameMax"] = maxAllocations;
+            jResults["allocations"]["bytesPerFrameAvg"] = (double)totalBytesAllocated / m_Settings.numFrames;
+        }
+        else
+        {
+            jResults["allocations"] = nullptr;
+        }
+
+        return jResults;
+    }
+
+protected:
+    BenchmarkFramework& m_Framework;
+    BenchmarkSettings m_Settings;
+    std::vector<std::string> m_MaterialNames;
+    std::vector<fw::Material*> m_Materials;
+};
+
+//====================
+// Main
+//====================
+
+int main(int argc, char** argv)
+{
+    BenchmarkSettings settings;
+    if( ParseArguments( argc, argv, settings ) == false )
+        return 1;
+
+    BenchmarkFramework framework( 1280, 720 );
+    framework.SetNumWorkerThreads( settings.numThreads );
+    framework.SetParallelSubmission( settings.parallelSubmit );
+
+    nlohmann::json jResults;
+    {
+        BenchmarkGame game( framework, settings );
+        jResults = game.Run();
+    }
+
+    std::string jsonString = jResults.dump( 4 );
+    if( settings.outputFilename )
+    {
+        fw::SaveCompleteFile( settings.outputFilename, jsonString.c_str(), (uint32)jsonString.length() );
+    }
+    else
+    {
+        printf( "%s\n", jsonString.c_str() );
+    }
+
+    return 0;
+}
@@ -0,0 +1,1114 @@
+//
+// Copyright (c) 2024 Jimmy Lord
+//
+// This software is provided 'as-is', without any express or implied warranty.  In no event will the authors be held liable for any damages arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose, including commercial applications, and to alter it and redistribute it freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+// Mesh builder.
+// Converts an OBJ into the binary mesh format (see Resources/MeshFormat.h), run it as part of the content build.
+// Each usemtl group becomes a submesh, and each submesh is optimized in place:
+//    1. Vertex cache: triangles are reordered with Tom Forsyth's linear-speed algorithm.
+//    2. Overdraw: the cache friendly order is split into clusters, which are sorted so outward facing
+//       clusters draw first. Splits only happen where the cluster's ACMR is within --overdraw-threshold
+//       of the mesh's, so the cache gains are mostly kept. 0 disables this step.
+//    3. Vertex fetch: vertices are renumbered in the order they're first used, unused ones are dropped.
+// --lods N adds N simplified LODs, each with --lod-ratio times the triangles of the one before it.
+//   They share the full mesh's vertices and are stored after it in the index buffer. LOD 0 is drawn while the
+//   mesh is at least --lod-screen-size of the view's height, and each LOD after that halves the size.
+// --quantize stores positions and UVs as halfs and normals as 16-bit snorm, 20 bytes a vertex instead of 32.
+//
+// ACMR (cache misses per triangle), ATVR (cache misses per vertex) and vertex fetch overfetch (bytes read from
+//   memory over bytes of vertex data) are reported before and after, to stdout or to the file passed with --stats.
+//
+// Usage:
+//    MeshBuilder [--cache-size N] [--overdraw-threshold T] [--no-optimize] [--quantize] [--stats file.json]
+//                [--lods N] [--lod-ratio R] [--lod-screen-size S] --output file.mesh input.obj
+
+#include "Framework.h"
+
+#include <tuple>
+
+//====================
+// Settings
+//====================
+
+struct MeshBuilderSettings
+{
+    uint32 cacheSize = 16;
+    float overdrawThreshold = 1.05f;
+    bool optimize = true;
+    bool quantize = false;
+    uint32 numLODs = 0;
+    float lodRatio = 0.5f;
+    float lodScreenSize = 0.5f;
+    const char* statsFilename = nullptr;
+    const char* outputFilename = nullptr;
+    const char* inputFilename = nullptr;
+};
+
+static bool ParseArguments(int argc, char** argv, MeshBuilderSettings& settings)
+{
+    for( int i=1; i<argc; i++ )
+    {
+        const char* arg = argv[i];
+
+        // Options without values.
+        if(      strcmp( arg, "--no-optimize" ) == 0 ) { settings.optimize = false; continue; }
+        else if( strcmp( arg, "--quantize" ) == 0 )    { settings.quantize = true; continue; }
+
+        // Anything else that isn't an option is the input file.
+        if( strncmp( arg, "--", 2 ) != 0 )
+        {
+            settings.inputFilename = arg;
+            continue;
+        }
+
+        const char* value = i+1 < argc ? argv[i+1] : nullptr;
+        if( value == nullptr )
+        {
+            fprintf( stderr, "Missing value for %s\n", arg );
+            return false;
+        }
+
+        if(      strcmp( arg, "--cache-size" ) == 0 )         settings.cacheSize = (uint32)atoi( value );
+        else if( strcmp( arg, "--overdraw-threshold" ) == 0 ) settings.overdrawThreshold = (float)atof( value );
+        else if( strcmp( arg, "--stats" ) == 0 )              settings.statsFilename = value;
+        else if( strcmp( arg, "--lods" ) == 0 )               settings.numLODs = (uint32)atoi( value );
+        else if( strcmp( arg, "--lod-ratio" ) == 0 )          settings.lodRatio = (float)atof( value );
+        else if( strcmp( arg, "--lod-screen-size" ) == 0 )    settings.lodScreenSize = (float)atof( value );
+        else if( strcmp( arg, "--output" ) == 0 )             settings.outputFilename = value;
+        else
+        {
+            fprintf( stderr, "Unknown argument: %s\n", arg );
+            return false;
+        }
+
+        i++;
+    }
+
+    if( settings.outputFilename == nullptr || settings.inputFilename == nullptr )
+    {
+        fprintf( stderr, "Usage: MeshBuilder [--cache-size N] [--overdraw-threshold T] [--no-optimize] [--quantize] [--stats file.json] [--lods N] [--lod-ratio R] [--lod-screen-size S] --output file.mesh input.obj\n" );
+        return false;
+    }
+
+    if( settings.cacheSize < 4 || settings.cacheSize > 64 )
+    {
+        fprintf( stderr, "--cache-size must be between 4 and 64\n" );
+        return false;
+    }
+
+    if( settings.lodRatio <= 0 || settings.lodRatio >= 1 )
+    {
+        fprintf( stderr, "--lod-ratio must be between 0 and 1\n" );
+        return false;
+    }
+
+    return true;
+}
+
+//====================
+// OBJ loading
+//====================
+
+struct SourceVertex
+{
+    fw::vec3 pos;
+    fw::vec3 normal;
+    fw::vec2 uv;
+};
+
+struct SourceMesh
+{
+    std::vector<SourceVertex> verts;
+    std::vector<uint32> indices;
+    std::vector<fw::MeshFileSubMesh> subMeshes;
+    std::vector<fw::MeshFileLOD> lods;
+    bool hasNormals = false;
+    bool hasUVs = false;
+};
+
+// OBJ indices are 1 based, negative ones count back from the end of the list.
+static int ResolveObjIndex(int index, size_t count)
+{
+    if( index < 0 )
+        return (int)count + index;
+    return index - 1;
+}
+
+static bool LoadObj(const char* filename, SourceMesh& mesh)
+{
+    FILE* fileHandle = fw::OpenFile( filename, "r" );
+    if( fileHandle == nullptr )
+        return false;
+
+    std::vector<fw::vec3> positions;
+    std::vector<fw::vec3> normals;
+    std::vector<fw::vec2> uvs;
+
+    // Triangles are gathered per material, then concatenated into submeshes.
+    std::map<std::string, std::vector<uint32>> groups;
+    std::vector<std::string> groupOrder;
+    std::string currentGroup;
+
+    // Each unique position/uv/normal combination becomes one vertex.
+    std::map<std::tuple<int, int, int>, uint32> vertexLookup;
+
+    char line[1024];
+    while( fgets( line, sizeof(line), fileHandle ) )
+    {
+        fw::vec3 v;
+        if( strncmp( line, "v ", 2 ) == 0 )
+        {
+            sscanf( line + 2, "%f %f %f", &v.x, &v.y, &v.z );
+            positions.push_back( v );
+        }
+        else if( strncmp( line, "vn ", 3 ) == 0 )
+        {
+            sscanf( line + 3, "%f %f %f", &v.x, &v.y, &v.z );
+            normals.push_back( v );
+        }
+        else if( strncmp( line, "vt ", 3 ) == 0 )
+        {
+            fw::vec2 uv;
+            sscanf( line + 3, "%f %f", &uv.x, &uv.y );
+            uvs.push_back( uv );
+        }
+        else if( strncmp( line, "usemtl ", 7 ) == 0 )
+        {
+            char name[256] = "";
+            sscanf( line + 7, "%255s", name );
+            currentGroup = name;
+        }
+        else if( strncmp( line, "f ", 2 ) == 0 )
+        {
+            if( groups.find( currentGroup ) == groups.end() )
+                groupOrder.push_back( currentGroup );
+            std::vector<uint32>& groupIndices = groups[currentGroup];
+
+            // Faces are triangulated as fans around their first corner.
+            std::vector<uint32> corners;
+            for( char* token = strtok( line + 2, " \t\r\n" ); token != nullptr; token = strtok( nullptr, " \t\r\n" ) )
+            {
+                int p = 0, t = 0, n = 0;
+                if( sscanf( token, "%d/%d/%d", &p, &t, &n ) != 3 )
+                {
+                    t = 0; n = 0;
+                    if( sscanf( token, "%d//%d", &p, &n ) != 2 )
+                    {
+                        n = 0;
+                        sscanf( token, "%d/%d", &p, &t );
+                    }
+                }
+
+                int pi = ResolveObjIndex( p, positions.size() );
+                int ti = t != 0 ? ResolveObjIndex( t, uvs.size() ) : -1;
+                int ni = n != 0 ? ResolveObjIndex( n, normals.size() ) : -1;
+                if( pi < 0 || pi >= (int)positions.size() || ti >= (int)uvs.size() || ni >= (int)normals.size() )
+                {
+                    fprintf( stderr, "Face references a missing vertex: %s\n", token );
+                    fclose( fileHandle );
+                    return false;
+                }
+
+                auto key = std::make_tuple( pi, ti, ni );
+                auto it = vertexLookup.find( key );
+                if( it == vertexLookup.end() )
+                {
+                    SourceVertex vertex;
+                    vertex.pos = positions[pi];
+                    vertex.uv = ti >= 0 ? uvs[ti] : fw::vec2( 0, 0 );
+                    vertex.normal = ni >= 0 ? normals[ni] : fw::vec3( 0, 0, 0 );
+                    mesh.hasUVs |= ti >= 0;
+                    mesh.hasNormals |= ni >= 0;
+
+                    it = vertexLookup.insert( { key, (uint32)mesh.verts.size() } ).first;
+                    mesh.verts.push_back( vertex );
+                }
+                corners.push_back( it->second );
+            }
+
+            for( size_t i=2; i<corners.size(); i++ )
+            {
+                groupIndices.push_back( corners[0] );
+                groupIndices.push_back( corners[i-1] );
+                groupIndices.push_back( corners[i] );
+            }
+        }
+    }
+
+    fclose( fileHandle );
+
+    for( const std::string& name : groupOrder )
+    {
+        std::vector<uint32>& groupIndices = groups[name];
+        mesh.subMeshes.push_back( { (uint32)mesh.indices.size(), (uint32)groupIndices.size() } );
+        mesh.indices.insert( mesh.indices.end(), groupIndices.begin(), groupIndices.end() );
+    }
+
+    return mesh.indices.empty() == false;
+}
+
+//====================
+// Statistics
+//====================
+
+struct MeshStats
+{
+    float acmr = 0;         // Post transform cache misses per triangle, 0.5 is ideal for a regular grid, 3 is the worst.
+    float atvr = 0;         // Post transform cache misses per vertex used, 1 is ideal.
+    float overfetch = 0;    // Bytes read through a simulated memory cache over bytes of vertex data used, 1 is ideal.
+
+    nlohmann::json ToJSON() const
+    {
+        nlohmann::json jStats;
+        jStats["ACMR"] = acmr;
+        jStats["ATVR"] = atvr;
+        jStats["Overfetch"] = overfetch;
+        return jStats;
+    }
+};
+
+// Simulates a FIFO post transform cache, like most hardware has. Returns the number of misses.
+static uint32 CountCacheMisses(const uint32* indices, uint32 numIndices, uint32 numVerts, uint32 cacheSize)
+{
+    std::vector<uint32> cacheTimestamps( numVerts, 0 );
+    uint32 timestamp = cacheSize + 1;
+    uint32 misses = 0;
+
+    for( uint32 i=0; i<numIndices; i++ )
+    {
+        // A vertex is in the cache if fewer than cacheSize misses happened since it was added.
+        if( timestamp - cacheTimestamps[indices[i]] > cacheSize )
+        {
+            cacheTimestamps[indices[i]] = timestamp++;
+            misses++;
+        }
+    }
+
+    return misses;
+}
+
+static MeshStats CalculateStats(const std::vector<uint32>& indices, uint32 numVerts, uint32 vertexStride, uint32 cacheSize)
+{
+    MeshStats stats;
+
+    uint32 numTriangles = (uint32)indices.size() / 3;
+    uint32 misses = CountCacheMisses( indices.data(), (uint32)indices.size(), numVerts, cacheSize );
+
+    std::vector<bool> used( numVerts, false );
+    uint32 numUsed = 0;
+    for( uint32 index : indices )
+    {
+        if( used[index] == false )
+            numUsed++;
+        used[index] = true;
+    }
+
+    // Vertex fetch goes through 64 byte lines in a small FIFO cache, roughly what a GPU's L1 looks like.
+    const uint32 c_LineSize = 64;
+    const uint32 c_NumLines = 64;
+    std::unordered_map<uint32, uint32> lineTimestamps;
+    uint32 timestamp = c_NumLines + 1;
+    uint64 bytesFetched = 0;
+    for( uint32 index : indices )
+    {
+        uint32 firstLine = index * vertexStride / c_LineSize;
+        uint32 lastLine = (index * vertexStride + vertexStride - 1) / c_LineSize;
+        for( uint32 line=firstLine; line<=lastLine; line++ )
+        {
+            auto it = lineTimestamps.find( line );
+            if( it == lineTimestamps.end() || timestamp - it->second > c_NumLines )
+            {
+                lineTimestamps[line] = timestamp++;
+                bytesFetched += c_LineSize;
+            }
+        }
+    }
+
+    stats.acmr = numTriangles ? (float)misses / numTriangles : 0;
+    stats.atvr = numUsed ? (float)misses / numUsed : 0;
+    stats.overfetch = numUsed ? (float)bytesFetched / ((uint64)numUsed * vertexStride) : 0;
+    return stats;
+}
+
+//====================
+// Vertex cache optimization
+//====================
+
+// Tom Forsyth's "Linear-Speed Vertex Cache Optimisation".
+// Each vertex is scored by its position in a simulated LRU cache and how many triangles still use it,
+//   the next triangle drawn is the highest scoring one touching the cache.
+class ForsythOptimizer
+{
+public:
+    static const uint32 c_MaxCacheSize = 64;
+
+    ForsythOptimizer(uint32 cacheSize) : m_CacheSize( cacheSize ) {}
+
+    void Optimize(uint32* indices, uint32 numIndices, uint32 numVerts)
+    {
+        uint32 numTriangles = numIndices / 3;
+
+        // Triangles using each vertex, as ranges in one shared list.
+        m_Verts.assign( numVerts, VertexData() );
+        for( uint32 i=0; i<numIndices; i++ )
+        {
+            m_Verts[indices[i]].numActiveTriangles++;
+        }
+
+        uint32 offset = 0;
+        for( VertexData& vert : m_Verts )
+        {
+            vert.firstTriangle = offset;
+            offset += vert.numActiveTriangles;
+            vert.numActiveTriangles = 0;
+        }
+
+        m_VertTriangles.resize( numIndices );
+        for( uint32 t=0; t<numTriangles; t++ )
+        {
+            for( int c=0; c<3; c++ )
+            {
+                VertexData& vert = m_Verts[indices[t*3 + c]];
+                m_VertTriangles[vert.firstTriangle + vert.numActiveTriangles++] = t;
+            }
+        }
+
+        for( VertexData& vert : m_Verts )
+        {
+            vert.score = ScoreVertex( vert );
+        }
+
+        m_TriangleEmitted.assign( numTriangles, false );
+
+        std::vector<uint32> output;
+        output.reserve( numIndices );
+
+        std::vector<uint32> cache;
+        std::vector<uint32> newCache;
+        uint32 nextUnemitted = 0;
+        int32 bestTriangle = -1;
+
+        for( uint32 emitted=0; emitted<numTriangles; emitted++ )
+        {
+            // Nothing in the cache had a triangle left, start from the first one not drawn yet.
+            if( bestTriangle == -1 )
+            {
+                while( m_TriangleEmitted[nextUnemitted] )
+                    nextUnemitted++;
+                bestTriangle = nextUnemitted;
+            }
+
+            uint32 t = bestTriangle;
+            m_TriangleEmitted[t] = true;
+
+            // Move the triangle's vertices to the front of the cache and drop it from their lists.
+            newCache.clear();
+            for( int c=0; c<3; c++ )
+            {
+                uint32 v = indices[t*3 + c];
+                output.push_back( v );
+                newCache.push_back( v );
+
+                VertexData& vert = m_Verts[v];
+                uint32* pTriangles = &m_VertTriangles[vert.firstTriangle];
+                for( uint32 i=0; i<vert.numActiveTriangles; i++ )
+                {
+                    if( pTriangles[i] == t )
+                    {
+                        std::swap( pTriangles[i], pTriangles[vert.numActiveTriangles-1] );
+                        vert.numActiveTriangles--;
+                        break;
+                    }
+                }
+            }
+            for( uint32 v : cache )
+            {
+                if( v != newCache[0] && v != newCache[1] && v != newCache[2] )
+                    newCache.push_back( v );
+            }
+
+            // Rescore everything that was in the cache, vertices pushed out fall back to their valence score.
+            for( uint32 i=0; i<newCache.size(); i++ )
+            {
+                VertexData& vert = m_Verts[newCache[i]];
+                vert.cachePosition = i < m_CacheSize ? (int32)i : -1;
+                vert.score = ScoreVertex( vert );
+            }
+            if( newCache.size() > m_CacheSize )
+                newCache.resize( m_CacheSize );
+            std::swap( cache, newCache );
+
+            // The next triangle is the best one still using a cached vertex.
+            bestTriangle = -1;
+            float bestScore = -1;
+            for( uint32 v : cache )
+            {
+                const VertexData& vert = m_Verts[v];
+                for( uint32 i=0; i<vert.numActiveTriangles; i++ )
+                {
+                    uint32 candidate = m_VertTriangles[vert.firstTriangle + i];
+                    float score = m_Verts[indices[candidate*3]].score + m_Verts[indices[candidate*3+1]].score + m_Verts[indices[candidate*3+2]].score;
+                    if( score > bestScore )
+                    {
+                        bestScore = score;
+                        bestTriangle = candidate;
+                    }
+                }
+            }
+        }
+
+        memcpy( indices, output.data(), numIndices * sizeof(uint32) );
+    }
+
+protected:
+    struct VertexData
+    {
+        uint32 firstTriangle = 0;
+        uint32 numActiveTriangles = 0;
+        int32 cachePosition = -1;
+        float score = 0;
+    };
+
+    float ScoreVertex(const VertexData& vert)
+    {
+        // No triangles left, never worth picking.
+        if( vert.numActiveTriangles == 0 )
+            return -1;
+
+        float score = 0;
+        if( vert.cachePosition >= 0 )
+        {
+            // The last triangle's vertices get a fixed score, so it doesn't just walk along a strip.
+            if( vert.cachePosition < 3 )
+                score = 0.75f;
+            else
+                score = powf( 1.0f - (float)(vert.cachePosition - 3) / (m_CacheSize - 3), 1.5f );
+        }
+
+        // Boost vertices with few triangles left, so they get finished off instead of left behind.
+        score += 2.0f * powf( (float)vert.numActiveTriangles, -0.5f );
+        return score;
+    }
+
+protected:
+    uint32 m_CacheSize;
+    std::vector<VertexData> m_Verts;
+    std::vector<uint32> m_VertTriangles;
+    std::vector<bool> m_TriangleEmitted;
+};
+
+//====================
+// Overdraw optimization
+//====================
+
+// Splits the triangles into clusters and draws the ones facing away from the mesh's center first,
+//   which tends to put occluders in front of what they hide.
+static void OptimizeOverdraw(uint32* indices, uint32 numIndices, const std::vector<SourceVertex>& verts, uint32 cacheSize, float threshold)
+{
+    uint32 numTriangles = numIndices / 3;
+    if( numTriangles < 2 )
+        return;
+
+    float meshACMR = (float)CountCacheMisses( indices, numIndices, (uint32)verts.size(), cacheSize ) / numTriangles;
+
+    // Find cluster starts. Triangles that miss on all 3 vertices already start fresh, other splits
+    //   are allowed once the current cluster's ACMR is within the threshold of the whole mesh's.
+    std::vector<uint32> clusterStarts;
+    std::vector<uint32> cacheTimestamps( verts.size(), 0 );
+    uint32 timestamp = cacheSize + 1;
+    uint32 clusterMisses = 0;
+    uint32 clusterTriangles = 0;
+    for( uint32 t=0; t<numTriangles; t++ )
+    {
+        uint32 misses = 0;
+        for( int c=0; c<3; c++ )
+        {
+            uint32 v = indices[t*3 + c];
+            if( timestamp - cacheTimestamps[v] > cacheSize )
+                misses++;
+        }
+
+        bool split = t == 0 || misses == 3 || (float)clusterMisses / clusterTriangles <= meshACMR * threshold;
+        if( split )
+        {
+            clusterStarts.push_back( t );
+            clusterMisses = 0;
+            clusterTriangles = 0;
+
+            // Clusters can be drawn in any order, so each one starts with a cold cache.
+            timestamp += cacheSize + 1;
+        }
+
+        for( int c=0; c<3; c++ )
+        {
+            uint32 v = indices[t*3 + c];
+            if( timestamp - cacheTimestamps[v] > cacheSize )
+            {
+                cacheTimestamps[v] = timestamp++;
+                clusterMisses++;
+            }
+        }
+        clusterTriangles++;
+    }
+    clusterStarts.push_back( numTriangles );
+
+    // Area weighted centroid of the whole mesh.
+    fw::vec3 meshCentroid( 0, 0, 0 );
+    float meshArea = 0;
+    for( uint32 t=0; t<numTriangles; t++ )
+    {
+        const fw::vec3& p0 = verts[indices[t*3]].pos;
+        const fw::vec3& p1 = verts[indices[t*3+1]].pos;
+        const fw::vec3& p2 = verts[indices[t*3+2]].pos;
+        float area = (p1 - p0).Cross( p2 - p0 ).Length();
+        meshCentroid += (p0 + p1 + p2) * (area / 3);
+        meshArea += area;
+    }
+    if( meshArea > 0 )
+        meshCentroid /= meshArea;
+
+    // Sort key is how far the cluster faces away from the center.
+    struct Cluster
+    {
+        uint32 start;
+        uint32 end;
+        float sortKey;
+    };
+    std::vector<Cluster> clusters;
+    for( size_t i=0; i+1<clusterStarts.size(); i++ )
+    {
+        fw::vec3 centroid( 0, 0, 0 );
+        fw::vec3 normal( 0, 0, 0 );
+        float area = 0;
+        for( uint32 t=clusterStarts[i]; t<clusterStarts[i+1]; t++ )
+        {
+            const fw::vec3& p0 = verts[indices[t*3]].pos;
+            const fw::vec3& p1 = verts[indices[t*3+1]].pos;
+            const fw::vec3& p2 = verts[indices[t*3+2]].pos;
+            fw::vec3 cross = (p1 - p0).Cross( p2 - p0 );
+            float triangleArea = cross.Length();
+            centroid += (p0 + p1 + p2) * (triangleArea / 3);
+            normal += cross;
+            area += triangleArea;
+        }
+        if( area > 0 )
+            centroid /= area;
+
+        clusters.push_back( { clusterStarts[i], clusterStarts[i+1], (centroid - meshCentroid).Dot( normal.GetNormalized() ) } );
+    }
+
+    std::stable_sort( clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; } );
+
+    std::vector<uint32> output;
+    output.reserve( numIndices );
+    for( const Cluster& cluster : clusters )
+    {
+        output.insert( output.end(), indices + cluster.start*3, indices + cluster.end*3 );
+    }
+    memcpy( indices, output.data(), numIndices * sizeof(uint32) );
+}
+
+//====================
+// Simplification
+//====================
+
+// Quadric error metric simplification (Garland and Heckbert), collapsing vertices onto neighbouring ones,
+//   so every LOD reuses the full mesh's vertices and only needs its own indices.
+// Vertices on open borders and on attribute seams (a position shared by more than one vertex) never move,
+//   which keeps silhouettes and UV/normal splits intact at the cost of simplifying less around them.
+class Simplifier
+{
+public:
+    Simplifier(const std::vector<SourceVertex>& verts)
+        : m_Verts( verts )
+    {
+        // Vertices split at seams have the same position, find them by comparing positions exactly.
+        std::map<std::tuple<float, float, float>, uint32> positionLookup;
+        m_PositionIDs.resize( verts.size() );
+        std::vector<uint32> positionCounts;
+        for( uint32 i=0; i<verts.size(); i++ )
+        {
+            auto key = std::make_tuple( verts[i].pos.x, verts[i].pos.y, verts[i].pos.z );
+            auto it = positionLookup.insert( { key, (uint32)positionCounts.size() } ).first;
+            if( it->second == positionCounts.size() )
+                positionCounts.push_back( 0 );
+            positionCounts[it->second]++;
+            m_PositionIDs[i] = it->second;
+        }
+
+        m_OnSeam.resize( verts.size() );
+        for( uint32 i=0; i<verts.size(); i++ )
+        {
+            m_OnSeam[i] = positionCounts[m_PositionIDs[i]] > 1;
+        }
+    }
+
+    // Returns the triangles simplified down to targetIndices indices, or as close as it can get.
+    std::vector<uint32> Simplify(const uint32* indices, uint32 numIndices, uint32 targetIndices)
+    {
+        std::vector<uint32> result( indices, indices + numIndices );
+        uint32 numVerts = (uint32)m_Verts.size();
+
+        // Lock seams, and borders, which are edges used by a single triangle.
+        std::vector<bool> locked = m_OnSeam;
+        std::unordered_map<uint64, uint32> edgeCounts;
+        for( uint32 i=0; i<numIndices; i+=3 )
+        {
+            for( int e=0; e<3; e++ )
+            {
+                edgeCounts[EdgeKey( result[i+e], result[i+(e+1)%3] )]++;
+            }
+        }
+        std::vector<bool> borderPosition( numVerts, false );
+        for( uint32 i=0; i<numIndices; i+=3 )
+        {
+            for( int e=0; e<3; e++ )
+            {
+                if( edgeCounts[EdgeKey( result[i+e], result[i+(e+1)%3] )] == 1 )
+                {
+                    borderPosition[m_PositionIDs[result[i+e]]] = true;
+                    borderPosition[m_PositionIDs[result[i+(e+1)%3]]] = true;
+                }
+            }
+        }
+        for( uint32 v=0; v<numVerts; v++ )
+        {
+            if( borderPosition[m_PositionIDs[v]] )
+                locked[v] = true;
+        }
+
+        // Each vertex starts with the planes of the triangles around it, weighted by area.
+        std::vector<Quadric> quadrics( numVerts );
+        for( uint32 i=0; i<numIndices; i+=3 )
+        {
+            const fw::vec3& p0 = m_Verts[result[i]].pos;
+            fw::vec3 cross = (m_Verts[result[i+1]].pos - p0).Cross( m_Verts[result[i+2]].pos - p0 );
+            float area = cross.Length();
+            if( area == 0 )
+                continue;
+
+            fw::vec3 normal = cross / area;
+            Quadric plane( normal, -normal.Dot( p0 ), area );
+            for( int c=0; c<3; c++ )
+            {
+                quadrics[result[i+c]].Add( plane );
+            }
+        }
+
+        std::vector<uint32> remap( numVerts );
+        for( uint32 v=0; v<numVerts; v++ )
+        {
+            remap[v] = v;
+        }
+
+        // Each pass collapses the cheapest edges whose vertices haven't been touched yet in the pass,
+        //   then rebuilds the triangles. Stops once on target or when nothing more can collapse.
+        while( result.size() > targetIndices )
+        {
+            struct Collapse
+            {
+                uint32 from;
+                uint32 to;
+                double cost;
+            };
+            std::vector<Collapse> collapses;
+            for( uint32 i=0; i<result.size(); i+=3 )
+            {
+                for( int e=0; e<3; e++ )
+                {
+                    uint32 a = result[i+e];
+                    uint32 b = result[i+(e+1)%3];
+                    Quadric combined = quadrics[a];
+                    combined.Add( quadrics[b] );
+                    if( locked[a] == false )
+                        collapses.push_back( { a, b, combined.Evaluate( m_Verts[b].pos ) } );
+                    if( locked[b] == false )
+                        collapses.push_back( { b, a, combined.Evaluate( m_Verts[a].pos ) } );
+                }
+            }
+            std::sort( collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; } );
+
+            BuildAdjacency( result );
+
+            std::vector<bool> touched( numVerts, false );
+            uint32 numTriangles = (uint32)result.size() / 3;
+            uint32 numCollapsed = 0;
+            for( const Collapse& collapse : collapses )
+            {
+                if( numTriangles * 3 <= targetIndices )
+                    break;
+
+                if( touched[collapse.from] || touched[collapse.to] )
+                    continue;
+
+                uint32 numRemoved;
+                if( CollapseFlipsTriangles( collapse.from, collapse.to, result, remap, &numRemoved ) )
+                    continue;
+
+                remap[collapse.from] = collapse.to;
+                quadrics[collapse.to].Add( quadrics[collapse.from] );
+                touched[collapse.from] = true;
+                touched[collapse.to] = true;
+                numTriangles -= numRemoved;
+                numCollapsed++;
+            }
+
+            if( numCollapsed == 0 )
+                break;
+
+            // Apply the collapses and drop the triangles that became degenerate.
+            std::vector<uint32> collapsed;
+            collapsed.reserve( result.size() );
+            for( uint32 i=0; i<result.size(); i+=3 )
+            {
+                uint32 a = Resolve( remap, result[i] );
+                uint32 b = Resolve( remap, result[i+1] );
+                uint32 c = Resolve( remap, result[i+2] );
+                if( a != b && b != c && c != a )
+                {
+                    collapsed.push_back( a );
+                    collapsed.push_back( b );
+                    collapsed.push_back( c );
+                }
+            }
+            result.swap( collapsed );
+        }
+
+        return result;
+    }
+
+protected:
+    // Symmetric 4x4 matrix, the sum of squared distances to a set of planes.
+    struct Quadric
+    {
+        double a[10] = {};
+
+        Quadric() {}
+        Quadric(fw::vec3 n, float d, float weight)
+        {
+            a[0] = n.x * n.x; a[1] = n.x * n.y; a[2] = n.x * n.z; a[3] = n.x * d;
+            a[4] = n.y * n.y; a[5] = n.y * n.z; a[6] = n.y * d;
+            a[7] = n.z * n.z; a[8] = n.z * d;
+            a[9] = d * d;
+            for( double& value : a )
+                value *= weight;
+        }
+
+        void Add(const Quadric& o)
+        {
+            for( int i=0; i<10; i++ )
+                a[i] += o.a[i];
+        }
+
+        double Evaluate(const fw::vec3& p) const
+        {
+            double x = p.x, y = p.y, z = p.z;
+            return x*x*a[0] + 2*x*y*a[1] + 2*x*z*a[2] + 2*x*a[3]
+                 + y*y*a[4] + 2*y*z*a[5] + 2*y*a[6]
+                 + z*z*a[7] + 2*z*a[8]
+                 + a[9];
+        }
+    };
+
+    // Edges use position IDs, so both sides of a seam count as the same edge.
+    uint64 EdgeKey(uint32 a, uint32 b) const
+    {
+        uint32 pa = m_PositionIDs[a];
+        uint32 pb = m_PositionIDs[b];
+        return pa < pb ? ((uint64)pa << 32) | pb : ((uint64)pb << 32) | pa;
+    }
+
+    static uint32 Resolve(const std::vector<uint32>& remap, uint32 v)
+    {
+        while( remap[v] != v )
+            v = remap[v];
+        return v;
+    }
+
+    void BuildAdjacency(const std::vector<uint32>& indices)
+    {
+        m_FirstTriangle.assign( m_Verts.size() + 1, 0 );
+        for( uint32 v : indices )
+            m_FirstTriangle[v+1]++;
+        for( size_t v=1; v<m_FirstTriangle.size(); v++ )
+            m_FirstTriangle[v] += m_FirstTriangle[v-1];
+
+        m_Triangles.resize( indices.size() );
+        std::vector<uint32> counts( m_Verts.size(), 0 );
+        for( uint32 i=0; i<indices.size(); i++ )
+        {
+            uint32 v = indices[i];
+            m_Triangles[m_FirstTriangle[v] + counts[v]++] = i / 3;
+        }
+    }
+
+    // Checks the triangles around 'from' once it's moved onto 'to'. Any that would turn more than ~75 degrees
+    //   block the collapse, so triangles can't flip over a few passes. The ones using both vertices are
+    //   counted, since they'll be removed.
+    bool CollapseFlipsTriangles(uint32 from, uint32 to, const std::vector<uint32>& indices, const std::vector<uint32>& remap, uint32* pNumRemoved)
+    {
+        *pNumRemoved = 0;
+        for( uint32 i=m_FirstTriangle[from]; i<m_FirstTriangle[from+1]; i++ )
+        {
+            uint32 t = m_Triangles[i];
+            uint32 corners[3];
+            for( int c=0; c<3; c++ )
+                corners[c] = Resolve( remap, indices[t*3 + c] );
+
+            if( corners[0] == to || corners[1] == to || corners[2] == to )
+            {
+                (*pNumRemoved)++;
+                continue;
+            }
+
+            fw::vec3 before = Normal( corners[0], corners[1], corners[2] );
+            for( int c=0; c<3; c++ )
+            {
+                if( corners[c] == from )
+                    corners[c] = to;
+            }
+            fw::vec3 after = Normal( corners[0], corners[1], corners[2] );
+
+            if( before.Dot( after ) <= 0.25f * before.Length() * after.Length() )
+                return true;
+        }
+
+        return false;
+    }
+
+    fw::vec3 Normal(uint32 a, uint32 b, uint32 c) const
+    {
+        const fw::vec3& p0 = m_Verts[a].pos;
+        return (m_Verts[b].pos - p0).Cross( m_Verts[c].pos - p0 );
+    }
+
+protected:
+    const std::vector<SourceVertex>& m_Verts;
+    std::vector<uint32> m_PositionIDs;
+    std::vector<bool> m_OnSeam;
+
+    // Triangles using each vertex, rebuilt every pass.
+    std::vector<uint32> m_FirstTriangle;
+    std::vector<uint32> m_Triangles;
+};
+
+// Fills in mesh.lods, simplifying each submesh of the previous LOD and appending the results to the index buffer.
+// Stops early if a LOD can't be simplified any further.
+static void BuildLODs(SourceMesh& mesh, const MeshBuilderSettings& settings)
+{
+    uint32 numSubMeshes = (uint32)mesh.subMeshes.size();
+    mesh.lods.push_back( { 0, numSubMeshes, 0.0f } );
+
+    Simplifier simplifier( mesh.verts );
+    ForsythOptimizer optimizer( settings.cacheSize );
+
+    for( uint32 level=1; level<=settings.numLODs; level++ )
+    {
+        const fw::MeshFileLOD& previous = mesh.lods.back();
+        fw::MeshFileLOD lod = { (uint32)mesh.subMeshes.size(), numSubMeshes, 0.0f };
+
+        uint32 previousIndices = 0;
+        uint32 newIndices = 0;
+        for( uint32 i=0; i<numSubMeshes; i++ )
+        {
+            fw::MeshFileSubMesh source = mesh.subMeshes[previous.firstSubMesh + i];
+            uint32 targetIndices = (uint32)(source.numIndices / 3 * settings.lodRatio) * 3;
+
+            std::vector<uint32> simplified = simplifier.Simplify( mesh.indices.data() + source.startIndex, source.numIndices, targetIndices );
+            if( settings.optimize && simplified.empty() == false )
+                optimizer.Optimize( simplified.data(), (uint32)simplified.size(), (uint32)mesh.verts.size() );
+
+            mesh.subMeshes.push_back( { (uint32)mesh.indices.size(), (uint32)simplified.size() } );
+            mesh.indices.insert( mesh.indices.end(), simplified.begin(), simplified.end() );
+
+            previousIndices += source.numIndices;
+            newIndices += (uint32)simplified.size();
+        }
+
+        if( newIndices == previousIndices )
+        {
+            mesh.indices.resize( mesh.subMeshes[lod.firstSubMesh].startIndex );
+            mesh.subMeshes.resize( lod.firstSubMesh );
+            break;
+        }
+
+        mesh.lods.push_back( lod );
+    }
+
+    // Every LOD but the last gets a threshold, each half the one before it.
+    float screenSize = settings.lodScreenSize;
+    for( uint32 i=0; i+1<mesh.lods.size(); i++ )
+    {
+        mesh.lods[i].minScreenSize = screenSize;
+        screenSize *= 0.5f;
+    }
+}
+
+//====================
+// Vertex fetch optimization
+//====================
+
+// Renumbers vertices in the order the index buffer first uses them, so fetches walk forward through memory.
+static void OptimizeVertexFetch(SourceMesh& mesh)
+{
+    const uint32 c_Unused = 0xFFFFFFFF;
+    std::vector<uint32> remap( mesh.verts.size(), c_Unused );
+    std::vector<SourceVertex> newVerts;
+    newVerts.reserve( mesh.verts.size() );
+
+    for( uint32& index : mesh.indices )
+    {
+        if( remap[index] == c_Unused )
+        {
+            remap[index] = (uint32)newVerts.size();
+            newVerts.push_back( mesh.verts[index] );
+        }
+        index = remap[index];
+    }
+
+    mesh.verts.swap( newVerts );
+}
+
+//====================
+// Output
+//====================
+
+static void BuildVertexLayout(const SourceMesh& mesh, bool quantize, bgfx::VertexLayout& layout)
+{
+    // Halfs and snorms are padded to 4 components, 3 component 16-bit formats aren't supported everywhere.
+    layout.begin();
+    if( quantize )
+    {
+        layout.add( bgfx::Attrib::Position, 4, bgfx::AttribType::Half );
+        if( mesh.hasNormals )
+            layout.add( bgfx::Attrib::Normal, 4, bgfx::AttribType::Int16, true );
+        if( mesh.hasUVs )
+            layout.add( bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Half );
+    }
+    else
+    {
+        layout.add( bgfx::Attrib::Position, 3, bgfx::AttribType::Float );
+        if( mesh.hasNormals )
+            layout.add( bgfx::Attrib::Normal, 3, bgfx::AttribType::Float );
+        if( mesh.hasUVs )
+            layout.add( bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Float );
+    }
+    layout.end();
+}
+
+static std::vector<uint8> PackVertices(const SourceMesh& mesh, const bgfx::VertexLayout& layout)
+{
+    std::vector<uint8> data( mesh.verts.size() * layout.getStride() );
+    for( uint32 i=0; i<mesh.verts.size(); i++ )
+    {
+        const SourceVertex& vert = mesh.verts[i];
+
+        float pos[4] = { vert.pos.x, vert.pos.y, vert.pos.z, 1.0f };
+        bgfx::vertexPack( pos, false, bgfx::Attrib::Position, layout, data.data(), i );
+
+        if( mesh.hasNormals )
+        {
+            fw::vec3 normal = vert.normal.GetNormalized();
+            float n[4] = { normal.x, normal.y, normal.z, 0.0f };
+            bgfx::vertexPack( n, true, bgfx::Attrib::Normal, layout, data.data(), i );
+        }
+
+        if( mesh.hasUVs )
+        {
+            float uv[4] = { vert.uv.x, vert.uv.y, 0.0f, 0.0f };
+            bgfx::vertexPack( uv, false, bgfx::Attrib::TexCoord0, layout, data.data(), i );
+        }
+    }
+
+    return data;
+}
+
+//====================
+// Main
+//====================
+
+int main(int argc, char** argv)
+{
+    MeshBuilderSettings settings;
+    if( ParseArguments( argc, argv, settings ) == false )
+        return 1;
+
+    SourceMesh mesh;
+    if( LoadObj( settings.inputFilename, mesh ) == false )
+    {
+        fprintf( stderr, "Failed to load %s\n", settings.inputFilename );
+        return 1;
+    }
+
+    bgfx::VertexLayout layout;
+    BuildVertexLayout( mesh, settings.quantize, layout );
+
+    MeshStats before = CalculateStats( mesh.indices, (uint32)mesh.verts.size(), layout.getStride(), settings.cacheSize );
+
+    if( settings.optimize )
+    {
+        ForsythOptimizer optimizer( settings.cacheSize );
+        for( const fw::MeshFileSubMesh& subMesh : mesh.subMeshes )
+        {
+            uint32* pIndices = &mesh.indices[subMesh.startIndex];
+            optimizer.Optimize( pIndices, subMesh.numIndices, (uint32)mesh.verts.size() );
+
+            if( settings.overdrawThreshold > 0 )
+                OptimizeOverdraw( pIndices, subMesh.numIndices, mesh.verts, settings.cacheSize, settings.overdrawThreshold );
+        }
+
+    }
+
+    uint32 numFullIndices = (uint32)mesh.indices.size();
+    BuildLODs( mesh, settings );
+
+    if( settings.optimize )
+        OptimizeVertexFetch( mesh );
+
+    std::vector<uint32> fullIndices( mesh.indices.begin(), mesh.indices.begin() + numFullIndices );
+    MeshStats after = CalculateStats( fullIndices, (uint32)mesh.verts.size(), layout.getStride(), settings.cacheSize );
+
+    std::vector<uint8> vertexData = PackVertices( mesh, layout );
+    if( fw::SaveMeshFile( settings.outputFilename, layout, vertexData.data(), (uint32)mesh.verts.size(), mesh.indices.data(), (uint32)mesh.indices.size(), mesh.subMeshes, mesh.lods ) == false )
+    {
+        fprintf( stderr, "Failed to write %s\n", settings.outputFilename );
+        return 1;
+    }
+
+    nlohmann::json jStats;
+    jStats["Input"] = settings.inputFilename;
+    jStats["Vertices"] = mesh.verts.size();
+    jStats["Triangles"] = numFullIndices / 3;
+    jStats["SubMeshes"] = mesh.subMeshes.size() / mesh.lods.size();
+    jStats["VertexStride"] = layout.getStride();
+    jStats["CacheSize"] = settings.cacheSize;
+    jStats["Before"] = before.ToJSON();
+    jStats["After"] = after.ToJSON();
+
+    nlohmann::json jLODArray = nlohmann::json::array();
+    for( const fw::MeshFileLOD& lod : mesh.lods )
+    {
+        uint32 numIndices = 0;
+        for( uint32 i=0; i<lod.numSubMeshes; i++ )
+            numIndices += mesh.subMeshes[lod.firstSubMesh + i].numIndices;
+
+        nlohmann::json jLOD;
+        jLOD["Triangles"] = numIndices / 3;
+        jLOD["MinScreenSize"] = lod.minScreenSize;
+        jLODArray.push_back( jLOD );
+    }
+    jStats["LODs"] = jLODArray;
+
+    std::string jsonString = jStats.dump( 4 );
+    if( settings.statsFilename )
+        fw::SaveCompleteFile( settings.statsFilename, jsonString.c_str(), (uint32)jsonString.length() );
+    else
+        printf( "%s\n", jsonString.c_str() );
+
+    return 0;
+}